@@ -25,69 +25,717 @@
 *************************************************************************************/
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <pthread.h>
+#include <signal.h>
+#include <dirent.h>
+#include <errno.h>
+#include <new>
+#include "microsat.h"
+
+static inline double wall_clock() {                                 // Seconds on a monotonic clock
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+#ifdef MICROSAT_STATS                                               // Hot path counters and timers, compiled out
+#define STAT(x) x                                                   // unless built with -DMICROSAT_STATS
+#else
+#define STAT(x)
+#endif
+
+struct micro_input {                                                // The bytes of an input file: mapped, read or decompressed
+    char *data;
+    size_t size;
+    size_t mapped;                                                  // Non-zero if data is an mmap of that many bytes
+
+    micro_input() : data(0), size(0), mapped(0) {
+    }
+
+    ~micro_input() {
+        if (this->mapped)
+            munmap(this->data, this->mapped);
+        else
+            free(this->data);
+    }
+
+    int readAll(FILE* file) {                                       // Read a stream (pipe, stdin) into a growing buffer
+        size_t cap = 1 << 16;
+        this->data = (char *) malloc(cap);
+        while (this->data) {
+            size_t n = fread(this->data + this->size, 1, cap - this->size, file);
+            this->size += n;
+            if (n == 0)
+                return !ferror(file);
+            if (this->size == cap) {
+                char* store = (char *) realloc(this->data, cap *= 2);
+                if (!store)
+                    return 0;
+                this->data = store;
+            }
+        }
+        return 0;
+    }
+
+    int decompress(const char* tool, const char* filename) {        // Read the output of "tool -dc filename"
+        size_t i, len = strlen(filename);
+        char* command = (char *) malloc(4 * len + 32);
+        if (!command)
+            return 0;
+        char* c = command + sprintf(command, "%s -dc '", tool);
+        for (i = 0; i < len; i++)                                   // Quote the filename for the shell
+            if (filename[i] == '\'')
+                c += sprintf(c, "'\\''");
+            else
+                *(c++) = filename[i];
+        strcpy(c, "' 2>/dev/null");
+        FILE* pipe = popen(command, "r");
+        free(command);
+        if (!pipe)
+            return 0;
+        int ok = readAll(pipe);
+        return (pclose(pipe) == 0) && ok;                           // A failing tool means a missing or corrupt file
+    }
+
+    int open(const char* filename) {                                // Returns 0 if the file cannot be read
+        int fd = strcmp(filename, "-") ? ::open(filename, O_RDONLY) : dup(0);
+        if (fd < 0)
+            return 0;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0) {
+            unsigned char magic[6] = {0};
+            ssize_t n = pread(fd, magic, 6, 0);
+            if (n >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+                close(fd);
+                return decompress("gzip", filename);                // Transparently read gzip compressed files
+            }
+            if (n >= 6 && !memcmp(magic, "\xfd" "7zXZ\0", 6)) {
+                close(fd);
+                return decompress("xz", filename);                  // and xz compressed files
+            }
+            void* map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (map != MAP_FAILED) {                                // Regular files are mapped, not copied
+                madvise(map, st.st_size, MADV_SEQUENTIAL);
+                this->data = (char *) map;
+                this->size = this->mapped = st.st_size;
+                close(fd);
+                return 1;
+            }
+        }
+        FILE* file = fdopen(fd, "r");                               // Otherwise read the stream (pipes, terminals)
+        if (!file) {
+            close(fd);
+            return 0;
+        }
+        int ok = readAll(file);
+        fclose(file);
+        return ok;
+    }
+};
+
+struct micro_exchange {                                             // Lock-free ring buffer of short lemmas shared by solvers
+    enum {
+        SLOTS = 1 << 12, WIDTH = 8                                  // Number of slots, and longest clause that is shared
+    };
+
+    struct slot {
+        unsigned long long seq;                                     // 2 * ticket + 2 once written, odd while being written
+        int owner;
+        int size;
+        int lits[WIDTH];
+    };
+
+    slot slots[SLOTS];
+    unsigned long long head;                                        // Next ticket to hand out
+
+    micro_exchange() : head(0) {
+        memset(this->slots, 0, sizeof(this->slots));
+    }
+
+    void put(int owner, const int* lits, int size) {                // Publish a clause, dropped if the slot is busy
+        unsigned long long ticket = __atomic_fetch_add(&this->head, 1, __ATOMIC_RELAXED);
+        slot* s = &this->slots[ticket % SLOTS];
+        unsigned long long seq = __atomic_load_n(&s->seq, __ATOMIC_RELAXED);
+        if ((seq & 1) || !__atomic_compare_exchange_n(&s->seq, &seq, 2 * ticket + 1, 0,
+                                                      __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            return;                                                 // Another writer lapped us on this slot
+        int i;
+        __atomic_store_n(&s->owner, owner, __ATOMIC_RELAXED);
+        __atomic_store_n(&s->size, size, __ATOMIC_RELAXED);
+        for (i = 0; i < size; i++)
+            __atomic_store_n(&s->lits[i], lits[i], __ATOMIC_RELAXED);
+        __atomic_store_n(&s->seq, 2 * ticket + 2, __ATOMIC_RELEASE);
+    }
+
+    int get(unsigned long long ticket, int* owner, int* lits) {     // Copy clause ticket, returns its size or -1 if lost
+        slot* s = &this->slots[ticket % SLOTS];
+        if (__atomic_load_n(&s->seq, __ATOMIC_ACQUIRE) != 2 * ticket + 2)
+            return -1;
+        int i, size = __atomic_load_n(&s->size, __ATOMIC_RELAXED);
+        *owner = __atomic_load_n(&s->owner, __ATOMIC_RELAXED);
+        for (i = 0; i < size && i < WIDTH; i++)
+            lits[i] = __atomic_load_n(&s->lits[i], __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        return (__atomic_load_n(&s->seq, __ATOMIC_RELAXED) == 2 * ticket + 2) ? size : -1;
+    }
+};
+
+struct micro_proof {                                                // DRAT proof, written by a background thread
+    enum {
+        BUFFER = 1 << 22, ROOM = 16                                 // Size of each of the two buffers, and the most
+    };                                                              // bytes a single literal can take
+
+    int fd;
+    int binary;                                                     // Binary DRAT instead of text
+    char *buffers[2];
+    int active;                                                     // The buffer that is being filled
+    int fill;
+    int full;                                                       // Bytes handed to the writer (-1 when it is idle)
+    int stopping;
+    int failed;                                                     // A write failed, the proof is incomplete
+    long long bytes;
+    long long added;
+    long long deleted;
+    pthread_t thread;
+    pthread_mutex_t lock;
+    pthread_cond_t changed;
+
+    micro_proof() : fd(-1), binary(0), active(0), fill(0), full(-1), stopping(0), failed(0), bytes(0), added(0),
+                    deleted(0) {
+        this->buffers[0] = this->buffers[1] = 0;
+        pthread_mutex_init(&this->lock, 0);
+        pthread_cond_init(&this->changed, 0);
+    }
+
+    ~micro_proof() {
+        close();
+        pthread_mutex_destroy(&this->lock);
+        pthread_cond_destroy(&this->changed);
+    }
+
+    int open(const char* filename, int binaryFormat) {              // Returns 0 if the file or thread cannot be made
+        this->binary = binaryFormat;
+        this->buffers[0] = (char *) malloc(BUFFER);
+        this->buffers[1] = (char *) malloc(BUFFER);
+        if (this->buffers[0] && this->buffers[1]) {
+            this->fd = ::open(filename, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (this->fd >= 0 && !pthread_create(&this->thread, 0, writer, this))
+                return 1;
+        }
+        if (this->fd >= 0)
+            ::close(this->fd);
+        this->fd = -1;
+        free(this->buffers[0]);
+        free(this->buffers[1]);
+        this->buffers[0] = this->buffers[1] = 0;
+        return 0;
+    }
+
+    static void* writer(void* arg) {                                // Write each full buffer while the solver fills the other
+        micro_proof* P = (micro_proof *) arg;
+        pthread_mutex_lock(&P->lock);
+        for (;;) {
+            while (P->full < 0 && !P->stopping)
+                pthread_cond_wait(&P->changed, &P->lock);
+            if (P->full < 0)
+                break;
+            const char* data = P->buffers[P->active ^ 1];
+            int size = P->full, done = 0;
+            pthread_mutex_unlock(&P->lock);
+            while (done < size) {
+                ssize_t n = write(P->fd, data + done, size - done);
+                if (n <= 0)
+                    break;
+                done += (int) n;
+            }
+            pthread_mutex_lock(&P->lock);
+            P->failed |= (done < size);
+            P->full = -1;
+            pthread_cond_broadcast(&P->changed);
+        }
+        pthread_mutex_unlock(&P->lock);
+        return 0;
+    }
+
+    void handOff() {                                                // Give the active buffer to the writer
+        pthread_mutex_lock(&this->lock);
+        while (this->full >= 0)
+            pthread_cond_wait(&this->changed, &this->lock);         // Only waits when the disk falls behind
+        this->full = this->fill;
+        this->active ^= 1;
+        this->fill = 0;
+        pthread_cond_broadcast(&this->changed);
+        pthread_mutex_unlock(&this->lock);
+    }
+
+    void put(int lit) {                                             // Append a literal, or the terminating 0
+        if (this->fill + ROOM > BUFFER)
+            handOff();
+        char* out = this->buffers[this->active] + this->fill, *start = out;
+        if (this->binary) {                                         // 2 * var + sign in 7-bit groups, low bits first
+            unsigned u = 2u * (unsigned) abs(lit) + (lit < 0);
+            while (u > 127) {
+                *(out++) = (char) (128 | (u & 127));
+                u >>= 7;
+            }
+            *(out++) = (char) u;
+        }
+        else {
+            char digits[12];
+            int n = 0;
+            unsigned u = (unsigned) abs(lit);
+            if (lit < 0)
+                *(out++) = '-';
+            do
+                digits[n++] = (char) ('0' + u % 10);
+            while (u /= 10);
+            while (n)
+                *(out++) = digits[--n];
+            *(out++) = lit ? ' ' : '\n';
+        }
+        this->fill += (int) (out - start);
+        this->bytes += out - start;
+    }
+
+    void clause(char type, const int* lits, int size) {             // type is 'a' to add, 'd' to delete
+        if (this->fd < 0)
+            return;
+        if (this->fill + 2 > BUFFER)
+            handOff();
+        char* out = this->buffers[this->active] + this->fill, *start = out;
+        if (this->binary)
+            *(out++) = type;
+        else if (type == 'd') {
+            *(out++) = 'd';
+            *(out++) = ' ';
+        }
+        this->fill += (int) (out - start);
+        this->bytes += out - start;
+        int i;
+        for (i = 0; i < size; i++)
+            put(lits[i]);
+        put(0);
+    }
+
+    void add(const int* lits, int size) {
+        clause('a', lits, size);
+        this->added++;
+    }
+
+    void remove(const int* lits, int size) {
+        clause('d', lits, size);
+        this->deleted++;
+    }
+
+    int close() {                                                   // Flush and stop the writer, returns 0 on failure
+        if (this->fd < 0)
+            return !this->failed;
+        if (this->fill)
+            handOff();
+        pthread_mutex_lock(&this->lock);
+        this->stopping = 1;
+        pthread_cond_broadcast(&this->changed);
+        pthread_mutex_unlock(&this->lock);
+        pthread_join(this->thread, 0);
+        this->failed |= (::close(this->fd) != 0);
+        this->fd = -1;
+        free(this->buffers[0]);
+        free(this->buffers[1]);
+        this->buffers[0] = this->buffers[1] = 0;
+        return !this->failed;
+    }
+};
 
 struct micro_solver {
     enum {
-        END = -9, UNSAT = 0, SAT = 1, MARK = 2, IMPLIED = 6
+        END = -9, CONFLICT = -4, UNKNOWN = -3, PARSE_ERROR = -2, MEMOUT = -1, UNSAT = 0, SAT = 1, MARK = 2, IMPLIED = 6
+    };
+    enum {
+        MEM_INIT = 1 << 16, MEM_SHRINK = 4                           // Initial arena size, and shrink ratio after reduceDB
+    };
+    enum {
+        LINKED = 0, BLOCKER = 1                                      // Propagation engines (see propagate)
+    };
+    enum {
+        MTF = 0, VMTF = 1, VSIDS = 2                                 // Decision heuristics (see decide)
+    };
+    enum {                                                           // Every clause starts with a header word:
+        CLAUSE = INT_MIN, USED = 1 << 30, GARBAGE = 1 << 29,         // the sign bit, used since the last reduceDB,
+        VIVIFIED = 1 << 28, LBD = (1 << 28) - 1                      // to be deleted, tried by vivify, and the LBD of lemmas
+    };
+
+    struct watcher {                                                 // Entry of a watch vector
+        int blocker;                                                 // Some other literal of the clause
+        int clause;                                                  // Offset of the clause in DB, negative for binary clauses
+    };
+
+    struct watchList {
+        watcher *w;
+        int size;
+        int cap;
     };
 
 public:
-    int *DB;
-    int nVars;
-    int nClauses;
-    int mem_used;
-    int mem_fixed;
-    int mem_max;
-    int maxLemmas;
-    int nLemmas;
+    int *DB = 0;
+    int nVars = 0;
+    int maxVars = 0;                                                 // Number of variables the arrays have room for
+    int nClauses = 0;
+    int mem_used = 0;
+    int mem_fixed = 0;
+    int mem_max = 0;                                                 // Current capacity of DB (in ints)
+    int mem_peak = 0;                                                // Largest mem_used seen so far
+    int mem_limit = 0;                                               // Hard upper bound on the capacity of DB
+    int maxLemmas = 0;
+    int nLemmas = 0;
     int *buffer;
-    int nConflicts;
-    // TODO: set maxconflicts for "timeout"
-    int maxconflicts = INT_MAX;
-    int *model;
-    int *reason;
+    int nConflicts = 0;
+    int maxconflicts = INT_MAX;                                      // Budgets of a single call to solve, after which
+    long long maxPropagations = LLONG_MAX;                           // it returns UNKNOWN (seconds and bytes of DB
+    double maxSeconds = 0;                                           // are not limited when 0)
+    long long maxMemory = 0;
+    int memoryReduced = 0;                                           // A reduceDB forced by maxMemory since the last one
+    int interrupted = 0;                                             // Set by interrupt(), possibly from another thread
+    int resumable = 0;                                               // The last call returned UNKNOWN and can continue
+    int startConflicts = 0;                                          // Counters at the start of the current call
+    long long startPropagations = 0;
+    double startTime = 0;
+    struct variable {                                                // Trail data of a variable, together in 8 bytes
+        int reason;                                                  // 1 + offset of its reason, 0 for decisions
+        signed char phase;                                           // Value to decide (and of the last assignment)
+        signed char seen;                                            // Analysis flags: MARK, IMPLIED or IMPLIED - 1
+    };
+
+    int *model;                                                      // The model after a SAT answer
+    variable *vars;
     int *mfalseStack;
-    int *mfalse;
+    signed char *value;                                              // Per literal: 1 true, -1 false, 0 unassigned
     int *first;
+    watchList *watches;                                              // Per-literal watch vectors of the BLOCKER engine
+    int engine = BLOCKER;                                            // Either LINKED or BLOCKER
+    long long nPropagations = 0;                                     // Number of false literals processed by propagate
     int *forced;
     int *processed;
     int *assigned;
     int *next;
     int *prev;
-    int head;
-    int res;
-    int fast;
-    int slow;
+    int head = 0;
+    int search = 0;                                                  // Where decide continues its walk over the list
+    int heuristic = MTF;                                             // Either MTF, VMTF or VSIDS
+    int ordered = 0;                                                 // The heuristic the order below was built for
+    int *bumped;                                                     // VMTF: when a variable was last moved to the front
+    int nBumps = 0;
+    double *score;                                                   // VSIDS: activity of each variable
+    double scoreInc = 1;
+    double scoreDecay = 0.95;                                        // scoreInc grows by 1/scoreDecay per conflict
+    int *heap;                                                       // VSIDS: binary max-heap of variables by score,
+    int *heapPos;                                                    // with 1-based positions (0 if not in the heap)
+    int nHeap = 0;
+    int *minimize;                                                   // Explicit stack of implied: literal, reason position
+    int res = 0;
+    const char *error = 0;                                           // Reason for the last PARSE_ERROR
+    int error_line = 0;                                              // and the line on which it was found
+    size_t parsed_bytes = 0;                                         // Size of the (decompressed) input
+    int fast = 0;
+    int slow = 0;
+    int inconsistent = 0;                                            // The clauses are unsatisfiable without assumptions
+    int *pending;                                                    // Clauses given to add() that are not yet in DB
+    int nPending = 0;
+    int pendingCap = 0;
+    int *assumptions;                                                // Assumptions of the current call to solve
+    int nAssumptions = 0;
+    int assumeNext = 0;                                              // Assumptions before this index are known to be true
+    int *assumeTrail;                                                // as long as assigned does not drop below this pointer
+    int *core;                                                       // Failed assumptions of the last UNSAT answer
+    int nCore = 0;
+    int *marks;                                                      // Per-variable stamps for clause normalization and cores
+    int stamp = 0;
+    int restartRatio = 60;                                           // Restart when fast > restartRatio% of slow
+    int tier1LBD = 2;                                                // Lemmas up to this LBD are never deleted,
+    int tier2LBD = 6;                                                // up to this LBD they survive while used
+    int lemmaStep = 300;                                             // Increment of maxLemmas after each reduceDB
+    const int *terminate = 0;                                        // solve returns UNKNOWN once this becomes non-zero
+    micro_exchange *exchange = 0;                                    // Lemmas are shared through this buffer if set
+    int shareId = 0;                                                 // Owner id of the lemmas put in the exchange
+    int shareLBD = 2;                                                // Share units, binaries and lemmas up to this LBD
+    unsigned long long shareNext = 0;                                // Next ticket to import from the exchange
+    long long nExported = 0;
+    long long nImported = 0;
+    micro_proof *proof = 0;                                          // Lemmas and deletions are logged here if set (for
+                                                                     // one formula: not with add() after solve, or sharing)
+
+    struct occList {                                                 // Clauses (offsets in DB) containing a literal
+        int *c;
+        int size;
+        int cap;
+    };
+
+    struct pass {                                                    // What a simplification pass removed
+        int clauses;
+        int variables;
+        int literals;
+        double seconds;
+    };
+
+    int *eliminated;                                                 // Variables removed by preprocess, and
+    int *frozen;                                                     // those that preprocess has to keep
+    int nEliminated = 0;
+    int *extension;                                                  // Clauses removed by elimination (witness first)
+    int nExtension = 0;                                              // to extend the model of the remaining clauses
+    int extensionCap = 0;
+    occList *occs;                                                   // Occurrence lists, only during preprocess
+    int *irredundant;                                                // Offsets of the clauses, only during preprocess
+    int nIrredundant = 0;
+    int irredundantCap = 0;
+    double probeSeconds = 1;                                         // Time budgets of the preprocessing passes
+    double subsumeSeconds = 1;
+    double eliminateSeconds = 2;
+    int eliminateOccs = 16;                                          // Only eliminate variables with fewer occurrences
+    pass probing = {};                                               // Failed literals, and clauses simplified by units
+    pass subsumption = {};                                           // Subsumed clauses and strengthened literals
+    pass elimination = {};                                           // Eliminated variables and the net clause reduction
+    pass vivification = {};                                          // Shortened lemmas and the literals removed from them
+    pass minimization = {};                                          // Literals removed from lemmas by binary clauses
+    int reportConflicts = 0;                                         // propagate returns CONFLICT instead of learning
+    int vivifyEffort = 10;                                           // Percentage of propagations vivify may use (0 = off)
+    int vivifyInterval = 2000;                                       // Conflicts between two calls to vivify
+    int nextVivify = 0;
+    long long vivifyMark = 0;                                        // Propagations at the end of the last vivify
+    int *cubes;                                                      // Cubes made by cube, each ended by 0, the
+    int nCubes = 0;                                                  // hardest (fewest assigned variables) first
+    int cubesSize = 0;
+    int cubesCap = 0;
+    int *candidates;                                                 // Variables that lookahead may split on
+    int nCandidates = 0;
+    int lookaheadVars = 64;                                          // Number of those, by occurrences
+    int nRefutedCubes = 0;                                           // Branches that lookahead closed itself
+    double lookaheadSeconds = 0;
+    double progressSeconds = 0;                                      // Print a progress line this often during solve
+    double nextProgress = 0;
+#ifdef MICROSAT_STATS
+    struct statistics {
+        long long decisions;
+        long long visits;                                            // Watches (or watchers) looked at by propagate
+        long long restarts;
+        long long reductions;
+        long long imports;                                           // Calls to importShared
+        double parse;                                                // Seconds spent in each part of the solver
+        double propagate;                                            // (including analyze)
+        double analyze;
+        double reduce;
+    } stats = {};
+#endif
 
 public:
-    micro_solver() {
+    micro_solver() {                                                 // An empty solver: parse or initCDCL allocate the
+        clearStorage();                                              // storage, reset keeps it for the next formula
     }
-    ;
 
     ~micro_solver() {
-        // TODO: is this right?
-        if (DB) {
-            free(DB);
+        releaseStorage();
+    }
+
+    void clearStorage() {                                            // Forget all storage (without freeing it)
+        this->DB = 0;
+        this->mem_max = this->mem_used = 0;
+        this->maxVars = this->nVars = this->head = this->search = 0;
+        this->model = this->next = this->prev = this->buffer = this->mfalseStack = this->minimize = 0;
+        this->vars = 0;
+        this->value = 0;
+        this->bumped = this->heap = this->heapPos = 0;
+        this->score = 0;
+        this->first = this->marks = this->core = 0;
+        this->watches = 0;
+        this->forced = this->processed = this->assigned = this->assumeTrail = 0;
+        this->pending = this->assumptions = 0;
+        this->nPending = this->pendingCap = this->nAssumptions = 0;
+        this->eliminated = this->frozen = this->extension = this->irredundant = 0;
+        this->nExtension = this->extensionCap = this->nIrredundant = this->irredundantCap = 0;
+        this->occs = 0;
+        this->cubes = this->candidates = 0;
+        this->nCubes = this->cubesSize = this->cubesCap = this->nCandidates = 0;
+    }
+
+    void freeOccs() {                                                // Drop the occurrence lists of an unfinished preprocess
+        int i;
+        for (i = -this->nVars; this->occs && i <= this->nVars; i++)
+            free(this->occs[i].c);
+        free(this->occs ? this->occs - this->nVars : 0);
+        free(this->irredundant);
+        this->occs = 0;
+        this->irredundant = 0;
+        this->nIrredundant = this->irredundantCap = 0;
+    }
+
+    void releaseStorage() {                                          // Free everything, the solver is empty again
+        int i;
+        freeOccs();
+        free(this->DB);
+        free(this->model);
+        free(this->next);
+        free(this->prev);
+        free(this->bumped);
+        free(this->score);
+        free(this->heap);
+        free(this->heapPos);
+        free(this->buffer);
+        free(this->minimize);
+        free(this->vars);
+        free(this->mfalseStack);
+        if (this->maxVars) {                                         // The literal indexed arrays are centered
+            free(this->value - this->maxVars);
+            free(this->first - this->maxVars);
+            for (i = -this->maxVars; i <= this->maxVars; i++)
+                free(this->watches[i].w);
+            free(this->watches - this->maxVars);
+        }
+        free(this->pending);
+        free(this->assumptions);
+        free(this->core);
+        free(this->marks);
+        free(this->eliminated);
+        free(this->frozen);
+        free(this->extension);
+        free(this->cubes);
+        free(this->candidates);
+        clearStorage();
+    }
+
+    void reset() {                                                   // Forget the formula but keep the arena, the variable
+        int i, n = this->nVars + 1;                                  // arrays and the watch vectors for the next one
+        freeOccs();
+        for (i = -this->nVars; this->maxVars && i <= this->nVars; i++) { // Only the first nVars entries were ever used
+            this->value[i] = 0;
+            this->first[i] = END;
+            this->watches[i].size = 0;
         }
+        int* arrays[] = {this->model, this->next, this->prev, this->bumped, this->heap, this->heapPos, this->core,
+                         this->marks, this->eliminated, this->frozen};
+        for (i = 0; i < (int) (sizeof(arrays) / sizeof(int *)); i++)
+            if (arrays[i])                                           // (growVars may have failed half way)
+                memset(arrays[i], 0, sizeof(int) * n);
+        if (this->score)
+            memset(this->score, 0, sizeof(double) * n);
+        if (this->vars)
+            memset(this->vars, 0, sizeof(variable) * n);
+        this->nVars = this->head = this->search = 0;
+        this->forced = this->processed = this->assigned = this->assumeTrail = this->mfalseStack;
+        this->mem_used = 0;
+        this->nPending = this->nAssumptions = this->nExtension = this->nCubes = this->cubesSize = 0;
+        __atomic_store_n(&this->interrupted, 0, __ATOMIC_RELAXED);
     }
 
 
     void unassign(int lit) {
-        this->mfalse[lit] = 0;                                       // Unassign the literal
+        this->value[lit] = this->value[-lit] = 0;                    // Unassign the literal
+        int var = abs(lit);
+        if (this->heuristic == VMTF && this->bumped[var] > this->bumped[this->search])
+            this->search = var;                                      // Keep everything after search assigned
+        else if (this->heuristic == VSIDS && !this->heapPos[var])
+            heapInsert(var);
+    }
+
+    void heapUp(int var) {                                           // Move var up to its place in the heap
+        int i = this->heapPos[var];
+        while (i > 1 && this->score[this->heap[i / 2]] < this->score[var]) {
+            this->heap[i] = this->heap[i / 2];
+            this->heapPos[this->heap[i]] = i;
+            i /= 2;
+        }
+        this->heap[i] = var;
+        this->heapPos[var] = i;
+    }
+
+    void heapInsert(int var) {
+        this->heap[++this->nHeap] = var;
+        this->heapPos[var] = this->nHeap;
+        heapUp(var);
+    }
+
+    void heapPop() {                                                 // Remove the variable with the highest score
+        int var = this->heap[this->nHeap--], i = 1;
+        this->heapPos[this->heap[1]] = 0;
+        if (!this->nHeap)
+            return;
+        for (;;) {                                                   // Sift the last variable down from the root
+            int child = 2 * i;
+            if (child > this->nHeap)
+                break;
+            if (child < this->nHeap && this->score[this->heap[child + 1]] > this->score[this->heap[child]])
+                child++;
+            if (this->score[this->heap[child]] <= this->score[var])
+                break;
+            this->heap[i] = this->heap[child];
+            this->heapPos[this->heap[i]] = i;
+            i = child;
+        }
+        this->heap[i] = var;
+        this->heapPos[var] = i;
+    }
+
+    void buildOrder() {                                              // Derive the VMTF stamps and the VSIDS heap from
+        int var, rank = this->nVars;                                 // the decision list and the current assignment
+        this->nHeap = 0;
+        for (var = 1; var <= this->nVars; var++)
+            this->heapPos[var] = 0;
+        for (var = this->head; var; var = this->prev[var]) {
+            this->bumped[var] = rank--;
+            if (!this->value[var])
+                heapInsert(var);
+        }
+        this->nBumps = this->nVars;
+        this->search = this->head;
+        this->ordered = this->heuristic;
+    }
+
+    int decide() {                                                   // The next unassigned variable, 0 if there is none
+        int var;
+        if (this->heuristic == VSIDS) {
+            while (this->nHeap && (this->value[var = this->heap[1]] || this->eliminated[var]))
+                heapPop();                                           // Assigned variables are removed lazily
+            return this->nHeap ? this->heap[1] : 0;
+        }
+        for (var = this->search; this->value[var]; )
+            var = this->prev[var];                                   // Walk the list towards older variables
+        return this->search = var;
+    }
+
+    void backtrack(int* to) {                                        // Unassign the literals on falseStack after to
+        while (this->assigned > to)
+            unassign(*(--this->assigned));
+        if (this->processed > to)
+            this->processed = to;                                    // Reset the processed pointer (keep unprocessed units)
     }
 
     void restart() {                                                 // Perform a restart (i.e., unassign all variables)
-        while (this->assigned > this->forced)
-            unassign(*(--this->assigned));                           // Remove all unforced false lits from falseStack
-        this->processed = this->forced;                              // Reset the processed pointer
+        backtrack(this->forced);                                     // Remove all unforced false lits from falseStack
+        if (this->assigned < this->assumeTrail)
+            this->assumeNext = 0;                                    // Assumptions have to be checked again
     }
 
     void assign(int* reason, int forced) {                           // Make the first literal of the reason true
         int lit = reason[0];                                         // Let lit be the first ltieral in the reason
-        this->mfalse[-lit] = forced ? IMPLIED : 1;                   // Mark lit as true and IMPLIED if forced
+        this->value[lit] = 1;                                        // Mark lit as true
+        this->value[-lit] = -1;
         *(this->assigned++) = -lit;                                  // Push it on the assignment stack
-        this->reason[abs(lit)] = 1 + (int) ((reason) - this->DB);    // Set the reason clause of lit
-        this->model[abs(lit)] = (lit > 0);                           // Mark the literal as true in the model
+        variable* v = &this->vars[abs(lit)];
+        v->reason = 1 + (int) ((reason) - this->DB);                 // Set the reason clause of lit
+        v->phase = (lit > 0);                                        // Save the phase of the literal
+        v->seen = forced ? IMPLIED : 0;                              // and mark it IMPLIED if forced
+    }
+
+    void branch(int lit) {                                           // Make lit true as a decision (without a reason)
+        this->value[lit] = 1;
+        this->value[-lit] = -1;
+        *(this->assigned++) = -lit;
+        this->vars[abs(lit)].reason = 0;
+        this->vars[abs(lit)].seen = 0;
     }
 
     void addWatch(int lit, int mem) {                                // Add a watch pointer to a clause containing lit
@@ -95,23 +743,90 @@ public:
         this->first[lit] = mem;
     }
 
-    int* getMemory(int mem_size) {                       // Allocate memory of size mem_size
-        if (this->mem_used + mem_size > this->mem_max) { // In case the code is used within a code base
-            printf("c out of memory\n");
-            exit(0);
+    int pushWatch(int lit, int blocker, int clause) {                // Append a watcher to the vector of lit
+        watchList* list = &this->watches[lit];
+        if (list->size == list->cap) {
+            int cap = list->cap ? 2 * list->cap : 4;
+            watcher* store = (watcher *) realloc(list->w, sizeof(watcher) * cap);
+            if (!store)
+                return 0;
+            list->w = store;
+            list->cap = cap;
         }
+        list->w[list->size].blocker = blocker;
+        list->w[list->size++].clause = clause;
+        return 1;
+    }
+
+    int resizeDB(long long size) {                        // Set the capacity of DB to size ints (offsets stay valid)
+        if (size > this->mem_limit)
+            size = this->mem_limit;                       // Offsets are ints, so the arena can never exceed mem_limit
+        if (size < this->mem_used)
+            return 0;
+        int* store = (int *) realloc(this->DB, sizeof(int) * size);
+        if (!store)
+            return 0;                                     // Keep the old arena if the system is out of memory
+        this->DB = store;
+        this->mem_max = (int) size;
+        return 1;
+    }
+
+    int* getMemory(int mem_size) {                       // Allocate memory of size mem_size
+        long long need = this->mem_used + (long long) mem_size;
+        if (need > this->mem_max &&                       // Grow the arena geometrically when full
+            (!resizeDB(2 * (long long) this->mem_max + mem_size) || need > this->mem_max))
+            return 0;                                     // Report out of memory to the caller
         int *store = (this->DB + this->mem_used);         // Compute a pointer to the new memory location
         this->mem_used += mem_size;                       // Update the size of the used memory
+        if (this->mem_used > this->mem_peak)
+            this->mem_peak = this->mem_used;
         return store;                                     // Return the pointer
     }
 
+    int* getVars(int size) {                              // Allocate a zeroed per-variable array outside of DB
+        return (int *) calloc(size, sizeof(int));
+    }
+
+    int watchClause(int* in, int size, int used) {        // Watch in[0] and in[1] of the clause at offset used
+        if (size > 1 && this->engine == LINKED) {
+            addWatch(in[0], used + 1);                    // If the clause is not unit, then add
+            addWatch(in[1], used + 2);                    // Two watch pointers to the datastructure
+        }
+        else if (size > 1) {                              // Binary clauses are marked by a negative offset
+            int ref = (size == 2) ? -used : used;         // and their blocker is the other literal
+            if (!pushWatch(in[0], in[1], ref) || !pushWatch(in[1], in[0], ref))
+                return 0;
+        }
+        return 1;
+    }
+
+    int watchClauses(int from, int to) {                  // Watch all clauses stored in DB between from and to
+        while (from < to) {
+            int* clause = this->DB + from + 3;
+            int size = 0;
+            while (clause[size])
+                size++;
+            if (!watchClause(clause, size, from))
+                return 0;
+            from += size + 4;
+        }
+        return 1;
+    }
+
+    int refute() {                                        // The clauses are unsatisfiable without assumptions
+        if (this->proof && !this->inconsistent)
+            this->proof->add(0, 0);                       // The empty clause ends the proof
+        this->inconsistent = 1;
+        return UNSAT;
+    }
+
     int* addClause(int* in, int size, int irr) {          // Adds a clause stored in *in of size size
         int i, used = this->mem_used;                     // Store a pointer to the beginning of the clause
-        int* clause = getMemory(size + 3) + 2;            // Allocate memory for the clause in the database
-        if (size > 1) {
-            addWatch(in[0], used);                        // If the clause is not unit, then add
-            addWatch(in[1], used + 1);                    // Two watch pointers to the datastructure
-        }
+        int* clause = getMemory(size + 4);                // Allocate memory for the clause in the database
+        if (!clause || !watchClause(in, size, used))
+            return 0;                                     // Out of memory
+        clause[0] = CLAUSE;                               // The header, with the LBD set by the caller for lemmas
+        clause += 3;
         for (i = 0; i < size; i++)
             clause[i] = in[i];                            // Copy the clause from the buffer to the database
         clause[i] = 0;
@@ -122,15 +837,49 @@ public:
         return clause;                                   // Return the pointer to the clause is the database
     }
 
-    void reduceDB(int k) { // Removes "less useful" lemmas from DB
+    static int compareKeys(const void* a, const void* b) {
+        long long x = *(const long long *) a, y = *(const long long *) b;
+        return (x > y) - (x < y);
+    }
+
+    void reduceDB() {                                   // Removes "less useful" lemmas from DB (at the top level)
+        STAT(double started = wall_clock());
+        STAT(this->stats.reductions++);
         while (this->nLemmas > this->maxLemmas)
-            this->maxLemmas += 300;                     // Allow more lemmas in the future
-        this->nLemmas = 0;                              // Reset the number of lemmas
+            this->maxLemmas += this->lemmaStep;         // Allow more lemmas in the future
+
+        int i, size, n = 0;
+        long long* keys = (long long *) malloc(sizeof(long long) * (this->nLemmas + 1));
+        for (i = this->mem_fixed; i < this->mem_used; i += size + 4) { // Select the candidates for deletion
+            int *clause = this->DB + i + 3, header = this->DB[i], satisfied = 0;
+            for (size = 0; clause[size]; size++)
+                if (this->value[clause[size]] > 0)
+                    satisfied = 1;                      // Satisfied by a top-level unit
+            this->DB[i] &= ~USED;
+            if (satisfied)
+                this->DB[i] |= GARBAGE;
+            else if ((header & LBD) > this->tier1LBD && !(header & (USED | GARBAGE)) && keys)
+                keys[n++] = ((long long) (LBD - (header & LBD)) << 31) | i; // Unused tier2 and local lemmas
+        }
+        if (keys) {
+            qsort(keys, n, sizeof(long long), compareKeys); // Highest LBD first, then the oldest
+            for (i = 0; i < n / 2; i++)
+                this->DB[keys[i] & INT_MAX] |= GARBAGE; // Delete the worse half of the candidates
+            free(keys);
+        }
 
-        int i;
         for (i = -this->nVars; i <= this->nVars; i++) {  // Loop over the variables
             if (i == 0)
                 continue;
+            if (this->engine == BLOCKER) {              // Keep the watchers of input clauses
+                watchList* list = &this->watches[i];
+                int j, k = 0;
+                for (j = 0; j < list->size; j++)
+                    if (abs(list->w[j].clause) < this->mem_fixed)
+                        list->w[k++] = list->w[j];
+                list->size = k;
+                continue;
+            }
             int* watch = &this->first[i];               // Get the pointer to the first watched clause
             while (*watch != END)                       // As long as there are watched clauses
                 if (*watch < this->mem_fixed)
@@ -139,62 +888,120 @@ public:
                     *watch = this->DB[*watch];          // Otherwise (meaning an input clause) go to next watch
         }
 
-        int old_used = this->mem_used;
-        this->mem_used = this->mem_fixed;                      // Virtually remove all lemmas
-        for (i = this->mem_fixed + 2; i < old_used; i += 3) {  // While the old memory contains lemmas
-            int count = 0, head = i;                           // Get the lemma to which the head is pointing
-            while (this->DB[i]) {
-                int lit = this->DB[i++];                       // Count the number of literals
-                if ((lit > 0) == this->model[abs(lit)])        // That are satisfied by the current model
-                    count++;
+        int used = this->mem_fixed;                     // Compact the surviving lemmas in place
+        this->nLemmas = 0;
+        for (i = this->mem_fixed; i < this->mem_used; i += size + 4) {
+            for (size = 0; this->DB[i + 3 + size]; size++)
+                ;
+            if (this->DB[i] & GARBAGE) {
+                if (this->proof)
+                    this->proof->remove(this->DB + i + 3, size);
+                continue;
             }
-            if (count < k)
-                addClause(this->DB + head, i - head, 0);       // If the latter is smaller than k, add it back
+            memmove(this->DB + used, this->DB + i, sizeof(int) * (size + 4));
+            used += size + 4;
+            this->nLemmas++;
         }
+        this->mem_used = used;
+        watchClauses(this->mem_fixed, this->mem_used);  // Cannot fail: the watch vectors held these watchers before
+
+        if ((long long) this->mem_used * MEM_SHRINK < this->mem_max && this->mem_max > MEM_INIT)
+            resizeDB(this->mem_max / 2 > MEM_INIT ? this->mem_max / 2 : MEM_INIT); // Give unused arena back
+        STAT(this->stats.reduce += wall_clock() - started);
     }
 
     void bump(int lit) {                                       // Move the variable to the front of the decision list
-        if (this->mfalse[lit] != IMPLIED) {
-            this->mfalse[lit] = MARK;                          // MARK the literal as involved if not a top-level unit
-            int var = abs(lit);
-            if (var != this->head) {                           // In case var is not already the head of the list
+        int var = abs(lit);
+        if (this->vars[var].seen != IMPLIED) {
+            this->vars[var].seen = MARK;                       // MARK the literal as involved if not a top-level unit
+            if (this->heuristic == VSIDS) {                    // Or increase its score
+                if ((this->score[var] += this->scoreInc) > 1e100) {
+                    int i;                                     // Rescale all scores (this keeps the heap order)
+                    for (i = 1; i <= this->nVars; i++)
+                        this->score[i] *= 1e-100;
+                    this->scoreInc *= 1e-100;
+                }
+                if (this->heapPos[var])
+                    heapUp(var);
+            }
+            else if (var != this->head) {                      // In case var is not already the head of the list
                 this->prev[this->next[var]] = this->prev[var]; // Update the prev link, and
                 this->next[this->prev[var]] = this->next[var]; // Update the next link, and
                 this->next[this->head] = var;                  // Add a next link to the head, and
                 this->prev[var] = this->head;                  // Make var the new head
                 this->head = var;
+                if (this->nBumps == INT_MAX)
+                    buildOrder();                              // Renumber the stamps before they overflow
+                this->bumped[var] = ++this->nBumps;
             }
         }
     }
 
     int implied(int lit) {                                    // Check if lit(eral) is implied by MARK literals
-        if (this->mfalse[lit] > MARK)
-            return (this->mfalse[lit] & MARK);                // If checked before return old result
-        if (!this->reason[abs(lit)])
+        variable* v = &this->vars[abs(lit)];
+        if (v->seen > MARK)
+            return (v->seen & MARK);                          // If checked before return old result
+        if (!v->reason)
             return 0;                                         // In case lit is a decision, it is not implied
-        int* p = (this->DB + this->reason[abs(lit)] - 1);     // Get the reason of lit(eral)
-        while (*(++p))                                        // While there are literals in the reason
-            if ((this->mfalse[*p] ^ MARK) && !implied(*p)) {  // Recursively check if non-MARK literals are implied
-                this->mfalse[lit] = IMPLIED - 1;              // Mark and return not implied (denoted by IMPLIED - 1)
-                return 0;                                     // Mark and return that the literal is implied
+        int* stack = this->minimize, top = 0;                 // Depth-first search without recursion: each entry
+        stack[top++] = lit;                                   // is a literal and the position in its reason
+        stack[top++] = v->reason - 1;
+        while (top) {
+            int next = this->DB[++stack[top - 1]];            // The next literal in the reason on top of the stack
+            if (!next) {
+                this->vars[abs(stack[top - 2])].seen = IMPLIED; // All literals in the reason are implied
+                top -= 2;
+                continue;
             }
-        this->mfalse[lit] = IMPLIED;
+            v = &this->vars[abs(next)];
+            if (v->seen == MARK || v->seen == IMPLIED)
+                continue;                                     // MARK literals and implied ones are done
+            if (v->seen == IMPLIED - 1 || !v->reason) {
+                while (top) {                                 // Checked before or a decision: the literals on the
+                    this->vars[abs(stack[top - 2])].seen = IMPLIED - 1; // stack are not implied (IMPLIED - 1)
+                    top -= 2;
+                }
+                return 0;
+            }
+            stack[top++] = next;                              // The graph is acyclic, so the stack holds each
+            stack[top++] = v->reason - 1;                     // variable at most once
+        }
         return 1;
     }
 
+    int minimizeBinary(int size) {                            // Remove the literals of the lemma in buffer that a
+        int i, k = 1, mark = 2 * ++this->stamp;               // binary clause with the UIP literal buffer[0] implies
+        for (i = 1; i < size; i++)
+            this->marks[abs(this->buffer[i])] = mark + (this->buffer[i] > 0);
+        watchList* list = &this->watches[this->buffer[0]];
+        for (i = 0; i < list->size; i++) {
+            int other = list->w[i].blocker;                   // (buffer[0] | other) resolves -other away
+            if (list->w[i].clause < 0 && this->marks[abs(other)] == mark + (other < 0))
+                this->marks[abs(other)] = 0;
+        }
+        for (i = 1; i < size; i++)
+            if (this->marks[abs(this->buffer[i])] == mark + (this->buffer[i] > 0))
+                this->buffer[k++] = this->buffer[i];
+        this->minimization.literals += size - k;
+        return k;
+    }
+
     int* analyze(int* clause) {                               // Compute a resolvent from falsified clause
+        STAT(double started = wall_clock());
         this->res++;
         this->nConflicts++;                                   // Bump restarts and update the statistic
+        clause[-3] |= USED;                                   // Keep the clauses used in conflicts
         while (*clause)
             bump(*(clause++));                                // MARK all literals in the falsified clause
-        while (this->reason[abs(*(--this->assigned))]) {      // Loop on variables on falseStack until the last decision
-            if (this->mfalse[*this->assigned] == MARK) {      // If the tail of the stack is MARK
+        while (this->vars[abs(*(--this->assigned))].reason) { // Loop on variables on falseStack until the last decision
+            if (this->vars[abs(*this->assigned)].seen == MARK) { // If the tail of the stack is MARK
                 int *check = this->assigned;                  // Pointer to check if first-UIP is reached
-                while (this->mfalse[*(--check)] != MARK)      // Check for a MARK literal before decision
-                    if (!this->reason[abs(*check)])
+                while (this->vars[abs(*(--check))].seen != MARK) // Check for a MARK literal before decision
+                    if (!this->vars[abs(*check)].reason)
                         goto build;
                 // Otherwise it is the first-UIP so break
-                clause = this->DB + this->reason[abs(*this->assigned)]; // Get the reason and ignore first literal
+                clause = this->DB + this->vars[abs(*this->assigned)].reason; // Get the reason and ignore first literal
+                clause[-4] |= USED;
                 while (*clause)                                // MARK all literals in reason
                     bump(*(clause++));
             }
@@ -205,19 +1012,25 @@ public:
         int size = 0, lbd = 0, flag = 0;                      // Build conflict clause; Empty the clause buffer
         int* p = this->processed = this->assigned;            // Loop from tail to front
         while (p >= this->forced) {                           // Only literals on the stack can be MARKed
-            if ((this->mfalse[*p] == MARK) && !implied(*p)) { // If MARKed and not implied
+            variable* v = &this->vars[abs(*p)];
+            if ((v->seen == MARK) && !implied(*p)) {          // If MARKed and not implied
                 this->buffer[size++] = *p;
                 flag = 1;
             }                                                 // Add literal to conflict clause buffer
-            if (!this->reason[abs(*p)]) {
+            if (!v->reason) {
                 lbd += flag;
                 flag = 0;                                     // Increase LBD for a decision with a true flag
                 if (size == 1)
                     this->processed = p;
             }                                                 // And update the processed pointer
-            this->mfalse[*(p--)] = 1;                         // Reset the MARK flag for all variables on the stack
+            v->seen = 0;                                      // Reset the MARK flag for all variables on the stack
+            p--;
         }
+        if (this->engine == BLOCKER && size > 1 && (size = minimizeBinary(size)) == 1)
+            this->processed = this->forced;                   // Only the watch vectors list the binary clauses
 
+        if (this->heuristic == VSIDS)                         // Older bumps count less (without a bump to
+            this->scoreInc /= this->scoreDecay;               // rescale it, scoreInc would overflow otherwise)
         this->fast -= this->fast >> 5;
         this->fast += lbd << 15;                              // Update the fast moving average
         this->slow -= this->slow >> 15;
@@ -226,24 +1039,42 @@ public:
         while (this->assigned > this->processed)              // Loop over all unprocessed literals
             unassign(*(this->assigned--));                    // Unassign all lits between tail & head
         unassign(*this->assigned);                            // Assigned now equal to processed
-        this->buffer[size] = 0;                               // Terminate the buffer (and potentially print clause)
-        return addClause(this->buffer, size, 0);              // Add new conflict clause to redundant DB
+        if (this->assigned < this->assumeTrail)
+            this->assumeNext = 0;                             // Some assumptions may have been unassigned
+        this->buffer[size] = 0;                               // Terminate the buffer
+        if (this->proof)
+            this->proof->add(this->buffer, size);
+        if (this->exchange && size <= micro_exchange::WIDTH && (size <= 2 || lbd <= this->shareLBD)) {
+            this->exchange->put(this->shareId, this->buffer, size); // Offer short lemmas to the other solvers
+            this->nExported++;
+        }
+        int* lemma = addClause(this->buffer, size, 0);        // Add new conflict clause to redundant DB
+        if (lemma)
+            lemma[-3] |= (lbd < LBD) ? lbd : LBD;             // and keep its LBD for reduceDB
+        STAT(this->stats.analyze += wall_clock() - started);
+        return lemma;
     }
 
     int propagate() {                                         // Performs unit propagation
-        int forced = this->reason[abs(*this->processed)];     // Initialize forced flag
+        if (this->engine == BLOCKER)
+            return propagateBlocker();
+        if (this->processed == this->assigned)
+            return SAT;                                       // Nothing to do, e.g. when resuming an interrupted search
+        int forced = this->vars[abs(*this->processed)].reason; // Initialize forced flag
         while (this->processed < this->assigned) {            // While unprocessed false literals
             int lit = *(this->processed++);                   // Get first unprocessed literal
+            this->nPropagations++;
             int* watch = &this->first[lit];                   // Obtain the first watch pointer
             while (*watch != END) {                           // While there are watched clauses (watched by lit)
+                STAT(this->stats.visits++);
                 int i, unit = 1;                              // Let's assume that the clause is unit
                 int* clause = (this->DB + *watch + 1);        // Get the clause from DB
-                if (clause[-2] == 0)
-                    clause++;                                 // Set the pointer to the first literal in the clause
+                if (clause[-2] < END)
+                    clause++;                                 // Skip link1 if clause[-2] is the header
                 if (clause[0] == lit)
                     clause[0] = clause[1];                    // Ensure that the other watched literal is in front
                 for (i = 2; unit && clause[i]; i++)           // Scan the non-watched literals
-                    if (!this->mfalse[clause[i]]) {           // When clause[i] is not false, it is either true or unset
+                    if (this->value[clause[i]] >= 0) {        // When clause[i] is not false, it is either true or unset
                         clause[1] = clause[i];
                         clause[i] = lit;                      // Swap literals
                         int store = *watch;
@@ -254,15 +1085,19 @@ public:
                 if (unit) {                                   // If the clause is indeed unit
                     clause[1] = lit;
                     watch = (this->DB + *watch);              // Place lit at clause[1] and update next watch
-                    if (this->mfalse[-clause[0]])
+                    if (this->value[clause[0]] > 0)
                         continue;                             // If the other watched literal is satisfied continue
-                    if (!this->mfalse[clause[0]]) {           // If the other watched literal is falsified,
+                    if (this->value[clause[0]] >= 0) {        // If the other watched literal is falsified,
                         assign(clause, forced);               // A unit clause is found, and the reason is set
                     }
                     else {
                         if (forced)
                             return UNSAT;                     // Found a root level conflict -> UNSAT
+                        if (this->reportConflicts)
+                            return CONFLICT;                  // Leave the conflict to the caller
                         int* lemma = analyze(clause);         // Analyze the conflict return a conflict clause
+                        if (!lemma)
+                            return MEMOUT;                    // No room to store the lemma
                         if (!lemma[1])
                             forced = 1;                       // In case a unit clause is found, set forced flag
                         assign(lemma, forced);                // Assign the conflict clause as a unit
@@ -276,108 +1111,2235 @@ public:
         return SAT;                                               // Finally, no conflict was found
     }
 
+    int propagateBlocker() {                                  // Unit propagation over contiguous watch vectors
+        if (this->processed == this->assigned)
+            return SAT;                                       // Nothing to do, e.g. when resuming an interrupted search
+        int forced = this->vars[abs(*this->processed)].reason; // Initialize forced flag
+        while (this->processed < this->assigned) {            // While unprocessed false literals
+            int lit = *(this->processed++);                   // Get first unprocessed literal
+            this->nPropagations++;
+            watchList* list = &this->watches[lit];
+            watcher *i = list->w, *j = i, *end = i + list->size;
+            int* clause = 0;                                  // The falsified clause, if any
+            while (i < end) {
+                watcher w = *(i++);
+                STAT(this->stats.visits++);
+                if (this->value[w.blocker] > 0) {             // The blocker is true, so the clause is not visited
+                    *(j++) = w;
+                    continue;
+                }
+                if (w.clause < 0) {                           // Binary clauses are handled without DB lookups
+                    *(j++) = w;
+                    clause = this->DB - w.clause + 3;
+                    if (this->value[w.blocker] < 0)
+                        break;                                // Both literals are false
+                    if (clause[0] != w.blocker) {             // Put the implied literal in front
+                        clause[1] = clause[0];
+                        clause[0] = w.blocker;
+                    }
+                    assign(clause, forced);
+                    clause = 0;
+                    continue;
+                }
+                clause = this->DB + w.clause + 3;
+                if (clause[0] == lit) {                       // Ensure that the other watched literal is in front
+                    clause[0] = clause[1];
+                    clause[1] = lit;
+                }
+                w.blocker = clause[0];
+                if (this->value[w.blocker] > 0) {             // The other watched literal is true: make it the blocker
+                    *(j++) = w;
+                    clause = 0;
+                    continue;
+                }
+                int k;
+                for (k = 2; clause[k]; k++)                   // Scan the non-watched literals
+                    if (this->value[clause[k]] >= 0)          // When clause[k] is not false, it is either true or unset
+                        break;
+                if (clause[k]) {
+                    clause[1] = clause[k];
+                    clause[k] = lit;                          // Swap literals and move the watch to clause[1]
+                    if (!pushWatch(clause[1], w.blocker, w.clause))
+                        return MEMOUT;
+                    clause = 0;
+                    continue;
+                }
+                *(j++) = w;                                   // The clause is unit or falsified
+                if (this->value[w.blocker] < 0)
+                    break;
+                assign(clause, forced);                       // A unit clause is found, and the reason is set
+                clause = 0;
+            }
+            while (i < end)
+                *(j++) = *(i++);                              // Keep the watchers that were not visited
+            list->size = (int) (j - list->w);
+            if (clause) {                                     // Conflict
+                if (forced)
+                    return UNSAT;                             // Found a root level conflict -> UNSAT
+                if (this->reportConflicts)
+                    return CONFLICT;                          // Leave the conflict to the caller
+                int* lemma = analyze(clause);                 // Analyze the conflict return a conflict clause
+                if (!lemma)
+                    return MEMOUT;                            // No room to store the lemma
+                if (!lemma[1])
+                    forced = 1;                               // In case a unit clause is found, set forced flag
+                assign(lemma, forced);                        // Assign the conflict clause as a unit
+            }
+        }
+        if (forced)
+            this->forced = this->processed;                   // Set this->forced if applicable
+        return SAT;                                           // Finally, no conflict was found
+    }
+
+    int vivify() {                                                // Shorten tier1 and tier2 lemmas at the top level by
+        double start = wall_clock();                              // propagating the negation of their literals in turn
+        long long limit = this->nPropagations + (this->nPropagations - this->vivifyMark) * this->vivifyEffort / 100;
+        int i, j, size, end = this->mem_used, status = propagate();
+        this->reportConflicts = 1;
+        for (i = this->mem_fixed; status == SAT && i < end && this->nPropagations < limit; i += size + 4) {
+            int *clause = this->DB + i + 3, header = this->DB[i], k = 0, satisfied = 0;
+            for (size = 0; clause[size]; size++)
+                satisfied |= (this->value[clause[size]] > 0);
+            if ((header & (GARBAGE | VIVIFIED)) || (header & LBD) > this->tier2LBD || size < 3 || satisfied)
+                continue;
+            this->DB[i] |= VIVIFIED;                              // Every lemma is tried once
+            for (j = 0; j < size; j++)
+                this->buffer[j] = clause[j];                      // propagate may reorder the literals of clause
+            for (j = 0; j < size && status == SAT; j++) {
+                int lit = this->buffer[j];
+                if (this->value[lit] < 0)
+                    continue;                                     // The literals before imply -lit: drop lit
+                this->buffer[k++] = lit;
+                if (this->value[lit] > 0)
+                    break;                                        // The literals before imply lit: drop the rest
+                branch(-lit);
+                status = propagate();                             // A CONFLICT drops the rest as well
+            }
+            restart();
+            if (status == CONFLICT)
+                status = SAT;
+            if (status != SAT || k == size)
+                continue;
+            if (!k)
+                status = UNSAT;                                   // Cannot happen after the top level is propagated
+            else {
+                if (this->proof)
+                    this->proof->add(this->buffer, k);
+                int* lemma = addClause(this->buffer, k, 0);       // The old lemma is deleted by the next reduceDB
+                if (!lemma) {
+                    status = MEMOUT;
+                    continue;
+                }
+                lemma[-3] |= VIVIFIED | ((header & LBD) < k ? (header & LBD) : k);
+                this->DB[i] |= GARBAGE;
+                this->vivification.clauses++;
+                this->vivification.literals += size - k;
+                if (k == 1) {                                     // A new top-level unit
+                    assign(lemma, 1);
+                    status = propagate();
+                }
+            }
+        }
+        this->reportConflicts = 0;
+        this->vivifyMark = this->nPropagations;
+        this->nextVivify = this->nConflicts + this->vivifyInterval;
+        this->vivification.seconds += wall_clock() - start;
+        return status;
+    }
+
+    void progress() {                                             // Print a progress line in DIMACS comment format
+        double elapsed = wall_clock() - this->startTime;
+        printf("c progress %.1fs: %i conflicts, %i lemmas, %lld propagations (%.1f M/s), arena %.1f MB\n",
+               elapsed, this->nConflicts, this->nLemmas, this->nPropagations,
+               elapsed > 0 ? (this->nPropagations - this->startPropagations) / 1e6 / elapsed : 0,
+               this->mem_used * sizeof(int) / 1e6);
+        STAT(printf("c progress %.1fs: %lld decisions, %lld restarts, %lld reductions\n", elapsed,
+                    this->stats.decisions, this->stats.restarts, this->stats.reductions));
+        fflush(stdout);
+        this->nextProgress += this->progressSeconds;
+    }
+
+    void interrupt() {                                            // Ask the running solve to return UNKNOWN (thread and
+        __atomic_store_n(&this->interrupted, 1, __ATOMIC_RELAXED); // signal safe), the next call clears it
+    }
+
+    int budgetExhausted() {                                       // Check the interrupt flags and budgets of this call
+        if (__atomic_exchange_n(&this->interrupted, 0, __ATOMIC_RELAXED) ||
+            (this->terminate && __atomic_load_n(this->terminate, __ATOMIC_RELAXED)))
+            return 1;
+        if (this->nConflicts - this->startConflicts >= this->maxconflicts ||
+            this->nPropagations - this->startPropagations >= this->maxPropagations ||
+            (this->maxSeconds > 0 && wall_clock() - this->startTime >= this->maxSeconds))
+            return 1;
+        if (this->maxMemory > 0 && (long long) sizeof(int) * this->mem_used > this->maxMemory) {
+            if (this->memoryReduced)                              // Still over the budget, or again before the next
+                return 1;                                         // regular reduceDB: give up instead of thrashing
+            this->memoryReduced = 1;
+            restart();                                            // Try to get below the memory budget first
+            reduceDB();
+            return (long long) sizeof(int) * this->mem_used > this->maxMemory;
+        }
+        return 0;
+    }
+
+    int analyzeFinal(int lit) {                                   // Collect the assumptions that falsify assumption lit
+        int* p = this->assigned;
+        int mark = 2 * ++this->stamp;
+        this->nCore = 0;
+        this->core[this->nCore++] = lit;
+        this->marks[abs(lit)] = mark;
+        while (--p >= this->forced) {                             // Only decisions are assumptions at this point
+            int var = abs(*p);
+            if (this->marks[var] != mark)
+                continue;
+            if (!this->vars[var].reason)
+                this->core[this->nCore++] = -*p;                  // A decision: the assumption -*p is part of the core
+            else {
+                int* clause = this->DB + this->vars[var].reason;  // Otherwise mark the false literals of its reason
+                while (*clause)
+                    this->marks[abs(*(clause++))] = mark;
+            }
+        }
+        return UNSAT;
+    }
+
+    int importShared() {                                          // Add the lemmas of other solvers (at the root level)
+        unsigned long long head = __atomic_load_n(&this->exchange->head, __ATOMIC_ACQUIRE);
+        if (head - this->shareNext > micro_exchange::SLOTS)
+            this->shareNext = head - micro_exchange::SLOTS;      // Skip what has been overwritten already
+        int lits[micro_exchange::WIDTH];
+        for (; this->shareNext < head; this->shareNext++) {
+            int i, owner, size = this->exchange->get(this->shareNext, &owner, lits), satisfied = 0, k = 0;
+            if (size < 0 || owner == this->shareId)
+                continue;
+            for (i = 0; i < size; i++)                            // Simplify by the top-level units
+                if (this->value[lits[i]] > 0 || this->eliminated[abs(lits[i])])
+                    satisfied = 1;                                // (lemmas on eliminated variables are skipped)
+                else if (this->value[lits[i]] >= 0)
+                    lits[k++] = lits[i];
+            if (satisfied)
+                continue;
+            if (!k) {
+                return refute();                                  // All literals are false at the top level
+            }
+            int* clause = addClause(lits, k, 0);
+            if (!clause)
+                return MEMOUT;
+            clause[-3] |= k;                                      // The size bounds the LBD
+            if (k == 1)
+                assign(clause, 1);                                // A new top-level unit
+            this->nImported++;
+        }
+        return SAT;
+    }
+
+    void diversify(unsigned seed, int phase) {                    // Initial phase (0 false, 1 true, 2 random), and
+        int i, shuffle = (seed != 0);                             // a shuffled decision order unless seed is 0
+        for (i = 1; i <= this->nVars; i++) {
+            seed = seed * 1103515245u + 12345u;
+            if (!this->value[i])                                   // Keep the phase of assigned variables
+                this->vars[i].phase = (phase == 2) ? (seed >> 16) & 1 : phase;
+            int j = 1 + (seed >> 8) % i;                          // Shuffle the variables in buffer (Fisher-Yates)
+            this->buffer[i - 1] = this->buffer[j - 1];
+            this->buffer[j - 1] = i;
+        }
+        if (!shuffle)
+            return;
+        this->head = 0;
+        for (i = 0; i < this->nVars; i++) {                       // Link the variables in shuffled order
+            if (this->eliminated[this->buffer[i]])
+                continue;
+            this->prev[this->buffer[i]] = this->head;
+            this->next[this->head] = this->buffer[i];
+            this->head = this->buffer[i];
+            this->score[this->buffer[i]] = (i + 1) * 1e-9;        // Initial VSIDS order, below any bump
+        }
+        buildOrder();
+    }
+
     int solve() {                                                 // Determine satisfiability
-        int decision = this->head;
+        return solve(0, 0);
+    }
+
+    int solve(const int* assume, int n) {                         // Determine satisfiability under assumptions
+        int i, decision, ticks = 0;
         this->res = 0;                                            // Initialize the micro_solver
+        this->nCore = 0;
+        this->startConflicts = this->nConflicts;
+        this->startPropagations = this->nPropagations;
+        this->startTime = wall_clock();
+        __atomic_store_n(&this->interrupted, 0, __ATOMIC_RELAXED); // Only interrupts during this call count
+        if (this->inconsistent)
+            return UNSAT;
+        int resume = this->resumable && !this->nPending && n == this->nAssumptions;
+        for (i = 0; resume && i < n; i++)                         // Continue an interrupted search on the same query
+            resume = (assume[i] == this->assumptions[i]);
+        this->resumable = 0;
+        if (!resume) {
+            if (this->nEliminated && mentionsEliminated(assume, n) && restoreEliminated() != SAT)
+                return MEMOUT;                                    // Undo variable elimination if it is in the way
+            for (i = 0; i < n; i++)                               // Assumptions may introduce new variables
+                if (abs(assume[i]) > this->nVars && growVars(abs(assume[i])) != SAT)
+                    return MEMOUT;
+            int* store = (int *) realloc(this->assumptions, sizeof(int) * (n + 1));
+            if (!store)
+                return MEMOUT;
+            this->assumptions = store;
+            for (i = 0; i < n; i++)
+                this->assumptions[i] = assume[i];
+            this->nAssumptions = n;
+            this->assumeNext = 0;
+            this->assumeTrail = this->mfalseStack;
+            restart();                                            // Continue from the root level of a previous call
+            if (this->nPending && flushPending() != SAT)
+                return this->inconsistent ? UNSAT : MEMOUT;
+        }
+        if (this->ordered != this->heuristic)
+            buildOrder();                                         // The heuristic was changed since the last call
+        this->search = this->head;
+        this->nextProgress = this->startTime + this->progressSeconds;
+
         for (;;) {                                                // Main solve loop
             int old_nLemmas = this->nLemmas;                      // Store nLemmas to see whether propagate adds lemmas
-            if (propagate() == UNSAT)
-                return UNSAT;                                     // Propagation returns UNSAT for a root level conflict
+            STAT(double started = wall_clock());
+            int status = propagate();
+            STAT(this->stats.propagate += wall_clock() - started);
+            if (status == UNSAT)
+                refute();                                         // A root level conflict holds for all future calls
+            if (status != SAT)
+                return status;                                    // Propagation returns UNSAT for a root level conflict
 
-            if (this->nLemmas > old_nLemmas) {                    // If the last decision caused a conflict
-                decision = this->head;                            // Reset the decision heuristic to head
-                if (this->fast > (this->slow / 100) * 60) {      // If fast average is substantially larger than slow average
+            int conflict = (this->nLemmas > old_nLemmas), restarted = 0;
+            if (conflict) {                                       // If the last decision caused a conflict
+                if (this->heuristic == MTF)
+                    this->search = this->head;                    // Reset the decision heuristic to head
+                if (this->fast > (this->slow / 100) * this->restartRatio) { // If fast average is substantially larger than slow average
                 // printf("c restarting after %i conflicts (%i %i) %i\n", this->res, this->fast, this->slow, this->nLemmas > this->maxLemmas);
                     this->res = 0;
-                    this->fast = (this->slow / 100) * 60;
+                    this->fast = (this->slow / 100) * this->restartRatio;
                     restart();                                    // Restart and update the averages
-                    if (this->nLemmas > this->maxLemmas)
-                        reduceDB(6);                              // Reduce the DB when it contains too many lemmas
+                    STAT(this->stats.restarts++);
+                    if (this->nLemmas > this->maxLemmas) {
+                        reduceDB();                               // Reduce the DB when it contains too many lemmas
+                        this->memoryReduced = 0;                  // and allow another one for the memory budget
+                    }
+                    if (this->vivifyEffort && this->nConflicts >= this->nextVivify && (status = vivify()) != SAT)
+                        return (status == UNSAT) ? refute() : status; // Shorten the tier1 and tier2 lemmas
+                    STAT(this->stats.imports += (this->exchange != 0));
+                    if (this->exchange && (status = importShared()) != SAT)
+                        return status;                            // Add the lemmas learned by other solvers
+                    restarted = 1;
                 }
             }
+            if (conflict || !(++ticks & 255)) {                   // Checked after the restart and reduceDB, so that
+                if (this->progressSeconds > 0 && wall_clock() >= this->nextProgress)
+                    progress();                                   // a resumed call continues the same search
+                if (budgetExhausted()) {
+                    this->resumable = 1;                          // Out of budget, or interrupted: the next call
+                    return UNKNOWN;                               // propagates the trail and continues
+                }
+            }
+            if (restarted)
+                continue;                                         // Propagate imported units before deciding
+
+            while (this->assumeNext < this->nAssumptions) {       // Assumptions are decided before any other variable
+                int lit = this->assumptions[this->assumeNext];
+                if (this->value[lit] < 0)
+                    return analyzeFinal(lit);                     // The assumption is false: UNSAT under assumptions
+                if (this->value[lit] <= 0)
+                    break;
+                this->assumeNext++;                               // Already true, check the next one
+                this->assumeTrail = this->assigned;
+            }
+            if (this->assumeNext < this->nAssumptions) {          // Decide the next assumption
+                int lit = this->assumptions[this->assumeNext++];
+                branch(lit);
+                this->vars[abs(lit)].phase = (lit > 0);           // Decisions keep the phase in sync with the trail
+                this->assumeTrail = this->assigned;
+                STAT(this->stats.decisions++);
+                continue;
+            }
 
-            while (this->mfalse[decision] || this->mfalse[-decision]) { // As long as the temporay decision is assigned
-                decision = this->prev[decision];                     // Replace it with the next variable in the decision list
+            decision = decide();                                     // Pick an unassigned variable
+            STAT(this->stats.decisions++);
+            if (decision == 0) {
+                for (i = 1; i <= this->nVars; i++)
+                    this->model[i] = this->vars[i].phase;
+                extendModel();                                       // If the end of the list is reached, then a solution is found
+                return SAT;                                          // (after the eliminated variables get their values)
             }
-            if (decision == 0)
-                return SAT;                                          // If the end of the list is reached, then a solution is found
-            decision = this->model[decision] ? decision : -decision; // Otherwise, assign the decision variable based on the model
-            this->mfalse[-decision] = 1;                             // Assign the decision literal to true (change to IMPLIED-1?)
-            *(this->assigned++) = -decision;                         // And push it on the assigned stack
-            decision = abs(decision);
-            this->reason[decision] = 0;                              // Decisions have no reason clauses
+            decision = this->vars[decision].phase ? decision : -decision; // Otherwise, assign the decision variable based on the phase
+            branch(decision);                                        // Make it true and push it on the assigned stack
         }
     }
 
-    void initCDCL(int n, int m) {
-        if (n < 1)
-            n = 1;                                        // The code assumes that there is at least one variable
-        this->nVars = n;                                  // Set the number of variables
+    int initCDCL(int n, int m) {                          // Allocate the main datastructures, returns MEMOUT on failure
         this->nClauses = m;                               // Set the number of clauases
-        this->mem_max = 1 << 30;                          // Set the initial maximum memory
+        this->mem_limit = INT_MAX;                        // Offsets into DB are ints
         this->mem_used = 0;                               // The number of integers allocated in the DB
+        this->mem_peak = 0;                               // The largest number of integers allocated in the DB
         this->nLemmas = 0;                                // The number of learned clauses -- redundant means learned
         this->nConflicts = 0;                             // Under of conflicts which is used to updates scores
+        STAT(memset(&this->stats, 0, sizeof(this->stats)));
+        this->nPropagations = 0;                          // Number of literals processed by propagate
+        this->nExported = this->nImported = 0;            // Number of lemmas shared with other solvers
+        this->resumable = this->memoryReduced = 0;
+        this->shareNext = 0;
         this->maxLemmas = 3000;                           // Initial maximum number of learnt clauses
         this->fast = this->slow = 1 << 24;                // Initialize the fast and slow moving averages
 
-        this->DB = (int *) malloc(sizeof(int) * this->mem_max); // Allocate the initial database
-        this->model = getMemory(n + 1);                   // Full assignment of the (Boolean) variables (initially set to false)
-        this->next = getMemory(n + 1);                    // Next variable in the heuristic order
-        this->prev = getMemory(n + 1);                    // Previous variable in the heuristic order
-        this->buffer = getMemory(n);                      // A buffer to store a temporary clause
-        this->reason = getMemory(n + 1);                  // Array of clauses
-        this->mfalseStack = getMemory(n + 1);             // Stack of falsified literals -- this pointer is never changed
-        this->forced = this->mfalseStack;                 // Points inside *falseStack at first decision (unforced literal)
-        this->processed = this->mfalseStack;              // Points inside *falseStack at first unprocessed literal
-        this->assigned = this->mfalseStack;               // Points inside *falseStack at last unprocessed literal
-        this->mfalse = getMemory(2 * n + 1);
-        this->mfalse += n;                                // Labels for variables, non-zero means false
-        this->first = getMemory(2 * n + 1);
-        this->first += n;                                 // Offset of the first watched clause
+        reset();                                          // Reuse the storage of an earlier formula, if any
+        this->nBumps = this->nHeap = 0;
+        this->scoreInc = 1;
+        this->ordered = this->heuristic;
+        this->assumeNext = this->nCore = 0;
+        this->stamp = this->inconsistent = 0;
+        this->nEliminated = 0;
+        memset(&this->probing, 0, sizeof(pass));
+        memset(&this->subsumption, 0, sizeof(pass));
+        memset(&this->elimination, 0, sizeof(pass));
+        memset(&this->vivification, 0, sizeof(pass));
+        memset(&this->minimization, 0, sizeof(pass));
+        this->reportConflicts = this->nextVivify = 0;
+        this->nRefutedCubes = 0;
+        this->lookaheadSeconds = 0;
+        this->vivifyMark = 0;
+        if ((!this->DB && !resizeDB(MEM_INIT)) || (!this->maxVars && reserveVars(1) != SAT) || growVars(n) != SAT)
+            return MEMOUT;                                // Only clauses are stored in the (growable) DB
         this->DB[this->mem_used++] = 0;                   // Make sure there is a 0 before the clauses are loaded.
+        this->mem_fixed = this->mem_used;                 // No clauses yet
+        return SAT;
+    }
+
+    int growArray(int** array, int size, int cap) {       // Resize a per-variable array, zeroing the new entries
+        int* store = (int *) realloc(*array, sizeof(int) * cap);
+        if (!store)
+            return 0;
+        if (!*array)
+            size = 0;
+        memset(store + size, 0, sizeof(int) * (cap - size));
+        *array = store;
+        return 1;
+    }
+
+    int growArray(double** array, int size, int cap) {
+        double* store = (double *) realloc(*array, sizeof(double) * cap);
+        if (!store)
+            return 0;
+        if (!*array)
+            size = 0;
+        memset(store + size, 0, sizeof(double) * (cap - size));
+        *array = store;
+        return 1;
+    }
+
+    static void* allocLines(size_t bytes) {               // Zeroed memory in whole, aligned cache lines
+        void* store;
+        bytes = (bytes + 63) & ~(size_t) 63;
+        if (posix_memalign(&store, 64, bytes))
+            return 0;
+        return memset(store, 0, bytes);
+    }
+
+    int growArray(variable** array, int size, int cap) {  // Resize the per-variable trail data, on cache lines
+        variable* store = (variable *) allocLines(sizeof(variable) * cap);
+        if (!store)
+            return 0;
+        if (*array)
+            memcpy(store, *array, sizeof(variable) * size);
+        free(*array);
+        *array = store;
+        return 1;
+    }
+
+    void* growCentered(void* array, int size, int old, int cap) { // Resize an array indexed by literals -old..old
+        char* store = (char *) allocLines((size_t) size * (2 * cap + 1)); // (the -old end starts a cache line)
+        if (store && array)
+            memcpy(store + size * (cap - old), (char *) array - size * old, size * (2 * old + 1));
+        return store ? store + size * cap : 0;
+    }
+
+    int reserveVars(int cap) {                            // Make room for variables 1..cap (and their literals)
+        int i, old = this->maxVars;
+        int* stack = this->mfalseStack;
+        if (!growArray(&this->model, old + 1, cap + 1) || // Full assignment of the (Boolean) variables
+            !growArray(&this->vars, old + 1, cap + 1) ||      // Reasons, phases and analysis flags
+            !growArray(&this->next, old + 1, cap + 1) ||      // Next variable in the heuristic order
+            !growArray(&this->prev, old + 1, cap + 1) ||      // Previous variable in the heuristic order
+            !growArray(&this->bumped, old + 1, cap + 1) || // Move-to-front stamps
+            !growArray(&this->score, old + 1, cap + 1) || // Activities
+            !growArray(&this->heap, old + 1, cap + 1) ||      // Heap of variables
+            !growArray(&this->heapPos, old + 1, cap + 1) || // and their positions in the heap
+            !growArray(&this->buffer, old + 1, cap + 1) || // A buffer to store a temporary clause
+            !growArray(&this->minimize, 2 * (old + 1), 2 * (cap + 1)) || // Stack of implied (two ints per level)
+            !growArray(&this->core, old + 1, cap + 1) ||      // Failed assumptions
+            !growArray(&this->marks, old + 1, cap + 1) || // Stamps
+            !growArray(&this->eliminated, old + 1, cap + 1) || // Variables removed by preprocess
+            !growArray(&this->frozen, old + 1, cap + 1) || // and those it has to keep
+            !growArray(&this->mfalseStack, old + 1, cap + 1)) // Stack of falsified literals
+            return MEMOUT;
+        if (!stack)                                       // Points inside *falseStack at first decision (unforced literal),
+            this->forced = this->processed = this->assigned = this->assumeTrail = this->mfalseStack;
+        else {                                            // first unprocessed literal and last unprocessed literal
+            this->forced = this->mfalseStack + (this->forced - stack);
+            this->processed = this->mfalseStack + (this->processed - stack);
+            this->assigned = this->mfalseStack + (this->assigned - stack);
+            this->assumeTrail = this->mfalseStack + (this->assumeTrail - stack);
+        }
+
+        signed char* value = (signed char *) growCentered(this->value, sizeof(signed char), old, cap);
+        int* first = (int *) growCentered(this->first, sizeof(int), old, cap);
+        watchList* watches = (watchList *) growCentered(this->watches, sizeof(watchList), old, cap);
+        if (!value || !first || !watches) {               // Replace the literal indexed arrays all at once
+            free(value ? value - cap : 0);
+            free(first ? first - cap : 0);
+            free(watches ? watches - cap : 0);
+            return MEMOUT;
+        }
+        if (old) {
+            free(this->value - old);
+            free(this->first - old);
+            free(this->watches - old);
+        }
+        this->value = value;                              // Values of the literals
+        this->first = first;                              // Offset of the first watched clause
+        this->watches = watches;                          // Watch vectors
+        for (i = -cap; i <= cap; i++)
+            if (i < -old || i > old)
+                this->first[i] = END;
+        this->maxVars = cap;                              // Only now that every array has grown
+        return SAT;
+    }
 
+    int growVars(int n) {                                 // Add variables nVars+1..n (at any decision level)
+        if (n > this->maxVars && reserveVars((n > 2 * this->maxVars) ? n : 2 * this->maxVars) != SAT)
+            return MEMOUT;
         int i;
-        for (i = 1; i <= n; i++) {                        // Initialize the main datastructes:
-            this->prev[i] = i - 1;
-            this->next[i - 1] = i;                        // the double-linked list for variable-move-to-front,
-            this->model[i] = this->mfalse[-i] = this->mfalse[i] = 0; // the model (phase-saving), the false array,
-            this->first[i] = this->first[-i] = END;       // and first (watch pointers).
-        }
-        this->head = n;                                   // Initialize the head of the double-linked list
-    }
-
-    // Not used.
-    int parse(char* filename) {                                         // Parse the formula and initialize
-        int tmp;
-        FILE* input = fopen(filename, "r");
-        do {
-            tmp = fscanf(input, " p cnf %i %i \n", &this->nVars, &this->nClauses);
-            if (tmp > 0 && tmp != EOF)
-                break;
-            tmp = fscanf(input, "%*s\n");
-        }                                                               // In case a commment line was found
-        while (tmp != 2 && tmp != EOF);                                 // Skip it and read next line
-
-        initCDCL(this->nVars, this->nClauses);                          // Allocate the main datastructures
-        int nZeros = this->nClauses, size = 0;                          // Initialize the number of clauses to read
-        while (nZeros > 0) {                                            // While there are clauses in the file
-            int lit = 0;
-            tmp = fscanf(input, " %i ", &lit);                          // Read a literal.
-            if (!lit) {                                                 // If reaching the end of the clause
-                int* clause = addClause(this->buffer, size, 1);         // Then add the clause to data_base
-                if (!size || ((size == 1) && this->mfalse[clause[0]]))  // Check for empty clause or conflicting unit
-                    return UNSAT;                                       // If either is found return UNSAT
-                if ((size == 1) && !this->mfalse[-clause[0]]) {         // Check for a new unit
-                    assign(clause, 1);                                  // Directly assign new units (forced = 1)
+        for (i = this->nVars + 1; i <= n; i++) {          // New variables are unassigned, and are put
+            this->prev[i] = this->head;                   // at the head of the double-linked list
+            this->next[this->head] = i;                   // for variable-move-to-front,
+            this->head = i;
+            this->bumped[i] = ++this->nBumps;
+            this->search = i;
+            heapInsert(i);                                // and in the heap of VSIDS
+        }
+        this->nVars = n;
+        return SAT;
+    }
+
+    int add(int lit) {                                    // Add lit to the clause given to solve, 0 ends the clause
+        this->resumable = 0;
+        if (abs(lit) > this->nVars && growVars(abs(lit)) != SAT)
+            return MEMOUT;
+        if (this->nPending == this->pendingCap) {
+            int cap = this->pendingCap ? 2 * this->pendingCap : 256;
+            int* store = (int *) realloc(this->pending, sizeof(int) * cap);
+            if (!store)
+                return MEMOUT;
+            this->pending = store;
+            this->pendingCap = cap;
+        }
+        this->pending[this->nPending++] = lit;
+        return SAT;
+    }
+
+    int flushPending() {                                  // Insert the added clauses in DB in front of the lemmas
+        if (this->nEliminated && mentionsEliminated(0, 0) && restoreEliminated() != SAT)
+            return MEMOUT;                                // Undo variable elimination if it is in the way
+        int *p = this->pending, *end = p + this->nPending, *out = p;
+        int total = 0, added = 0;
+        while (p < end) {                                 // Simplify the clauses by the top-level units
+            int size = 0, satisfied = 0, *clause = out, mark = 2 * ++this->stamp;
+            for (; *p; p++) {
+                int lit = *p, var = abs(lit);
+                if (this->value[lit] > 0 || this->marks[var] == mark + (lit < 0))
+                    satisfied = 1;                        // Satisfied at the top level, or a tautology
+                else if (this->value[lit] >= 0 && this->marks[var] != mark + (lit > 0)) {
+                    this->marks[var] = mark + (lit > 0);  // Drop false and duplicate literals
+                    clause[size++] = lit;
                 }
-                size = 0;
-                --nZeros;
             }
-            else
-                this->buffer[size++] = lit;                             // Add literal to buffer
+            p++;
+            if (satisfied)
+                continue;
+            if (!size) {
+                return refute();                          // An empty clause
+            }
+            clause[size] = 0;
+            out = clause + size + 1;
+            total += size + 4;
+            added++;
         }
-        fclose(input);
-        return SAT;                                                     // Return that no conflict was observed
-    }
-};
+        this->nPending = 0;
+        if (!total)
+            return SAT;
+
+        int lemmas = this->mem_used - this->mem_fixed, from = this->mem_fixed;
+        if (!getMemory(total))
+            return MEMOUT;
+        memmove(this->DB + from + total, this->DB + from, sizeof(int) * lemmas);
+        for (p = this->pending; p < out; p++) {           // Copy the clauses into the gap before the lemmas
+            int* clause = this->DB + this->mem_fixed;
+            clause[0] = CLAUSE;
+            clause[1] = clause[2] = 0;
+            for (clause += 3; *p; p++)
+                *(clause++) = *p;
+            *clause = 0;
+            this->mem_fixed = (int) (clause + 1 - this->DB);
+        }
+        this->nClauses += added;
+        if (lemmas) {                                     // The lemmas moved, so all watches are rebuilt
+            int i;
+            for (i = -this->nVars; i <= this->nVars; i++) {
+                this->first[i] = END;
+                this->watches[i].size = 0;
+            }
+            from = 1;
+        }
+        if (!watchClauses(from, this->mem_used))
+            return MEMOUT;
+        for (p = this->DB + this->mem_fixed - total + 3; p < this->DB + this->mem_fixed; p += 4) {
+            if (!p[1]) {                                  // Assign the new unit clauses
+                if (this->value[p[0]] < 0) {
+                    return refute();
+                }
+                if (this->value[p[0]] <= 0)
+                    assign(p, 1);
+            }
+            while (*p)
+                p++;                                      // Skip to the next clause
+        }
+        this->forced = this->assigned;                    // Top-level units are forced immediately
+        return SAT;
+    }
+
+    int val(int lit) {                                    // Value of lit in the model after a SAT answer
+        return (abs(lit) <= this->nVars && this->model[abs(lit)] == (lit > 0)) ? lit : -lit;
+    }
+
+    int failed(int lit) {                                 // Was assumption lit used to derive the last UNSAT answer?
+        int i;
+        for (i = 0; i < this->nCore; i++)
+            if (this->core[i] == lit)
+                return 1;
+        return 0;
+    }
+
+    int freeze(int lit) {                                 // Keep the variable of lit out of variable elimination
+        if (abs(lit) > this->nVars && growVars(abs(lit)) != SAT)
+            return MEMOUT;
+        this->frozen[abs(lit)]++;
+        return SAT;
+    }
+
+    void melt(int lit) {                                  // Undo one call to freeze
+        if (abs(lit) <= this->nVars && this->frozen[abs(lit)])
+            this->frozen[abs(lit)]--;
+    }
+
+    int pushOcc(int lit, int offset) {                    // Add the clause at offset to the occurrences of lit
+        occList* list = &this->occs[lit];
+        if (list->size == list->cap) {
+            int cap = list->cap ? 2 * list->cap : 4;
+            int* store = (int *) realloc(list->c, sizeof(int) * cap);
+            if (!store)
+                return 0;
+            list->c = store;
+            list->cap = cap;
+        }
+        list->c[list->size++] = offset;
+        return 1;
+    }
+
+    void removeOcc(int lit, int offset) {
+        occList* list = &this->occs[lit];
+        int i = 0;
+        while (list->c[i] != offset)
+            i++;
+        list->c[i] = list->c[--list->size];
+    }
+
+    int satisfiedClause(int offset) {                     // Is the clause at offset satisfied at the top level?
+        int* clause = this->DB + offset + 3;
+        for (; *clause; clause++)
+            if (this->value[*clause] > 0)
+                return 1;
+        return 0;
+    }
+
+    int liveOccs(int lit) {                               // Drop deleted and satisfied clauses from the occurrences
+        occList* list = &this->occs[lit];
+        int i, k = 0;
+        for (i = 0; i < list->size; i++) {
+            int offset = list->c[i];
+            if (!(this->DB[offset] & GARBAGE) && satisfiedClause(offset))
+                deleteClause(offset);
+            if (!(this->DB[offset] & GARBAGE))
+                list->c[k++] = offset;
+        }
+        return list->size = k;
+    }
+
+    void deleteClause(int offset) {                       // Mark an irredundant clause as GARBAGE
+        if (this->proof)
+            this->proof->remove(this->DB + offset + 3, this->DB[offset] & LBD);
+        this->DB[offset] |= GARBAGE;
+    }
+
+    int fixUnit(int offset) {                             // Assign the unit clause at offset at the top level
+        int* clause = this->DB + offset + 3;
+        if (this->value[clause[0]] < 0) {
+            return refute();
+        }
+        if (this->value[clause[0]] <= 0)
+            assign(clause, 1);
+        return SAT;
+    }
+
+    int storeClause(int* in, int size) {                  // Add a resolvent with its occurrences, returns its offset
+        int i, used = this->mem_used;
+        int* clause = getMemory(size + 4);
+        if (!clause)
+            return 0;
+        clause[0] = CLAUSE | size;                        // During preprocess the header holds the size
+        clause[1] = clause[2] = 0;
+        for (i = 0; i < size; i++)
+            clause[i + 3] = in[i];
+        clause[size + 3] = 0;
+        if (this->proof)
+            this->proof->add(in, size);
+        if (this->nIrredundant == this->irredundantCap) {
+            int cap = 2 * this->irredundantCap + 16;
+            int* store = (int *) realloc(this->irredundant, sizeof(int) * cap);
+            if (!store)
+                return 0;
+            this->irredundant = store;
+            this->irredundantCap = cap;
+        }
+        this->irredundant[this->nIrredundant++] = used;
+        for (i = 0; i < size; i++)
+            if (!pushOcc(in[i], used))
+                return 0;
+        return used;
+    }
+
+    int probe() {                                         // Failed literal probing: a conflict after deciding a
+        double start = wall_clock();                      // literal makes analyze learn a top-level unit
+        int v, sign, status = propagate();
+        int* units = this->assigned;
+        for (v = 1; status == SAT && v <= this->nVars; v++) {
+            if (!(v & 15) && wall_clock() - start > this->probeSeconds)
+                break;
+            for (sign = 1; sign >= -1 && status == SAT; sign -= 2) {
+                int lit = sign * v, old_nLemmas = this->nLemmas;
+                if (this->value[lit] || this->eliminated[v])
+                    break;
+                branch(lit);                              // Decide lit
+                status = propagate();
+                if (status == SAT && this->nLemmas == old_nLemmas)
+                    restart();                            // No conflict, so undo the decision
+            }
+        }
+        if (status == UNSAT)
+            refute();
+        this->probing.variables += (int) (this->assigned - units);
+        this->probing.seconds += wall_clock() - start;
+        return status;
+    }
+
+    int collect() {                                       // Drop the lemmas and build the occurrence lists of the
+        int i, size, n = 0;                               // irredundant clauses simplified by the top-level units
+        for (i = this->mem_fixed; this->proof && i < this->mem_used; i += size + 4) {
+            for (size = 0; this->DB[i + 3 + size]; size++)
+                ;
+            this->proof->remove(this->DB + i + 3, size);
+        }
+        this->mem_used = this->mem_fixed;
+        this->nLemmas = 0;
+        for (i = -this->nVars; i <= this->nVars; i++) {
+            this->first[i] = END;
+            this->watches[i].size = 0;
+        }
+        for (i = 1; i < this->mem_fixed; i += size + 4)
+            for (size = 0, n++; this->DB[i + 3 + size]; size++)
+                ;
+        this->irredundant = (int *) malloc(sizeof(int) * (n + 1)); // Never fails later, so no clause can be lost
+        this->occs = (occList *) growCentered(0, sizeof(occList), 0, this->nVars);
+        if (!this->irredundant || !this->occs)
+            return MEMOUT;
+        this->irredundantCap = n + 1;
+        int status = SAT;
+        for (i = 1; i < this->mem_fixed; i += size + 4) {
+            int *clause = this->DB + i + 3, k = 0, satisfied = 0;
+            for (size = 0; clause[size]; size++)
+                if (this->value[clause[size]] > 0)
+                    satisfied = 1;
+                else if (this->value[clause[size]] >= 0) {
+                    int lit = clause[size];               // Move false literals behind the others
+                    clause[size] = clause[k];
+                    clause[k++] = lit;
+                }
+            if (satisfied) {
+                this->DB[i] = CLAUSE | size;
+                deleteClause(i);
+                this->probing.clauses++;
+                continue;
+            }
+            if (this->proof && k < size && k) {
+                this->proof->add(clause, k);
+                this->proof->remove(clause, size);
+            }
+            this->probing.literals += size - k;
+            this->DB[i] = CLAUSE | k;                     // During preprocess the header holds the size
+            clause[k] = 0;
+            this->irredundant[this->nIrredundant++] = i;
+            if (!k) {
+                status = refute();                        // All literals are false at the top level
+            }
+            else if (k == 1 && status == SAT)
+                status = fixUnit(i);
+            int j;
+            for (j = 0; j < k; j++)
+                if (status == SAT && !pushOcc(clause[j], i))
+                    status = MEMOUT;
+        }
+        return status;
+    }
+
+    int subsume() {                                       // Backward subsumption and self-subsuming resolution
+        double start = wall_clock();
+        int i, n = this->nIrredundant, status = SAT;
+        long long* keys = (long long *) malloc(sizeof(long long) * (n + 1));
+        if (!keys)
+            return MEMOUT;
+        for (i = 0; i < n; i++)                           // Shortest clauses first
+            keys[i] = ((long long) (this->DB[this->irredundant[i]] & LBD) << 31) | this->irredundant[i];
+        qsort(keys, n, sizeof(long long), compareKeys);
+        for (i = 0; i < n && status == SAT; i++) {
+            if (!(i & 63) && wall_clock() - start > this->subsumeSeconds)
+                break;
+            int c = (int) (keys[i] & INT_MAX), size = this->DB[c] & LBD, mark = 2 * ++this->stamp, j;
+            if ((this->DB[c] & GARBAGE) || size < 2)
+                continue;
+            int *lits = this->DB + c + 3, best = lits[0];
+            for (j = 0; j < size; j++) {                  // Mark C, and find its literal with the fewest occurrences
+                this->marks[abs(lits[j])] = mark + (lits[j] > 0);
+                if (this->occs[lits[j]].size + this->occs[-lits[j]].size <
+                    this->occs[best].size + this->occs[-best].size)
+                    best = lits[j];
+            }
+            int sign;
+            for (sign = 1; sign >= -1; sign -= 2) {       // Candidates contain best or -best
+                occList* list = &this->occs[sign * best];
+                for (j = list->size - 1; j >= 0 && status == SAT; j--) { // Backwards: D may leave this list
+                    int d = list->c[j], dsize = this->DB[d] & LBD, same = 0, flipped = 0, flip = 0, *q;
+                    if (d == c || (this->DB[d] & GARBAGE) || dsize < size)
+                        continue;
+                    for (q = this->DB + d + 3; *q; q++)
+                        if (this->marks[abs(*q)] == mark + (*q > 0))
+                            same++;
+                        else if (this->marks[abs(*q)] == mark + (*q < 0)) {
+                            flipped++;
+                            flip = *q;
+                        }
+                    if (same + flipped < size || flipped > 1)
+                        continue;                         // C is not contained in D (up to one flipped literal)
+                    if (!flipped) {
+                        deleteClause(d);                  // C subsumes D
+                        this->subsumption.clauses++;
+                        continue;
+                    }
+                    for (q = this->DB + d + 3; *q != flip; q++)
+                        ;
+                    *q = this->DB[d + 2 + dsize];         // Strengthen D by removing flip
+                    this->DB[d + 2 + dsize] = flip;
+                    if (this->proof) {
+                        this->proof->add(this->DB + d + 3, dsize - 1);
+                        this->proof->remove(this->DB + d + 3, dsize);
+                    }
+                    this->DB[d + 2 + dsize] = 0;
+                    this->DB[d]--;
+                    removeOcc(flip, d);
+                    this->subsumption.literals++;
+                    if (dsize == 2)
+                        status = fixUnit(d);
+                }
+            }
+        }
+        free(keys);
+        this->subsumption.seconds += wall_clock() - start;
+        return status;
+    }
+
+    int resolve(int c, int d, int pivot) {                // Resolve C (with pivot) and D (with -pivot) into buffer,
+        int size = 0, mark = 2 * ++this->stamp, *p;       // returns its size, or -1 if satisfied or tautological
+        for (p = this->DB + c + 3; *p; p++) {
+            if (*p == pivot || this->value[*p] < 0)
+                continue;
+            if (this->value[*p] > 0)
+                return -1;
+            this->marks[abs(*p)] = mark + (*p > 0);
+            this->buffer[size++] = *p;
+        }
+        for (p = this->DB + d + 3; *p; p++) {
+            if (*p == -pivot || this->value[*p] < 0 || this->marks[abs(*p)] == mark + (*p > 0))
+                continue;
+            if (this->value[*p] > 0 || this->marks[abs(*p)] == mark + (*p < 0))
+                return -1;
+            this->buffer[size++] = *p;
+        }
+        return size;
+    }
+
+    int pushExtension(int witness, int offset) {          // Save a removed clause for extendModel
+        int* clause = this->DB + offset + 3, size = this->DB[offset] & LBD, i;
+        if (this->nExtension + size + 1 > this->extensionCap) {
+            int cap = 2 * this->extensionCap + size + 1;
+            int* store = (int *) realloc(this->extension, sizeof(int) * cap);
+            if (!store)
+                return 0;
+            this->extension = store;
+            this->extensionCap = cap;
+        }
+        this->extension[this->nExtension++] = witness;
+        for (i = 0; i < size; i++)
+            if (clause[i] != witness)
+                this->extension[this->nExtension++] = clause[i];
+        this->extension[this->nExtension++] = 0;
+        return 1;
+    }
+
+    int eliminateVar(int v) {                             // Replace the clauses of v by their resolvents if that
+        int pos = liveOccs(v), neg = liveOccs(-v), i, j, count = 0; // does not increase the number of clauses
+        if (!pos && !neg)
+            return SAT;                                   // Not worth removing
+        if ((pos > this->eliminateOccs || neg > this->eliminateOccs) && pos && neg)
+            return SAT;
+        for (i = 0; i < pos; i++)
+            for (j = 0; j < neg; j++)
+                if (resolve(this->occs[v].c[i], this->occs[-v].c[j], v) >= 0 && ++count > pos + neg)
+                    return SAT;
+        for (i = 0; i < pos; i++)
+            for (j = 0; j < neg; j++) {
+                int size = resolve(this->occs[v].c[i], this->occs[-v].c[j], v), offset;
+                if (size < 0)
+                    continue;
+                if (!size) {
+                    return refute();
+                }
+                if (!(offset = storeClause(this->buffer, size)))
+                    return MEMOUT;                        // The resolvents so far are implied, so this is safe
+                if (size == 1 && fixUnit(offset) != SAT)
+                    return UNSAT;
+            }
+        int saved = this->nExtension;
+        for (i = 0; i < pos + neg; i++)                   // Save the clauses of v with v or -v as witness
+            if (!pushExtension(i < pos ? v : -v, i < pos ? this->occs[v].c[i] : this->occs[-v].c[i - pos])) {
+                this->nExtension = saved;                 // v stays, so none of its clauses may be extended
+                return MEMOUT;
+            }
+        for (i = 0; i < pos; i++)
+            deleteClause(this->occs[v].c[i]);
+        for (i = 0; i < neg; i++)
+            deleteClause(this->occs[-v].c[i]);
+        this->occs[v].size = this->occs[-v].size = 0;
+        this->eliminated[v] = 1;
+        this->nEliminated++;
+        if (v == this->head)                              // Take v out of the decision list
+            this->head = this->prev[v];
+        else {
+            this->prev[this->next[v]] = this->prev[v];
+            this->next[this->prev[v]] = this->next[v];
+        }
+        this->elimination.variables++;
+        this->elimination.clauses += pos + neg - count;
+        return SAT;
+    }
+
+    int eliminate() {                                     // Bounded variable elimination, cheapest variables first
+        double start = wall_clock();
+        int v, status = SAT, progress = 1;
+        long long* keys = (long long *) malloc(sizeof(long long) * (this->nVars + 1));
+        if (!keys)
+            return MEMOUT;
+        while (progress && status == SAT && wall_clock() - start < this->eliminateSeconds) {
+            int i, n = 0, before = this->nEliminated;
+            for (v = 1; v <= this->nVars; v++)
+                if (!this->eliminated[v] && !this->frozen[v] && !this->value[v]) {
+                    long long cost = (long long) this->occs[v].size * this->occs[-v].size;
+                    keys[n++] = ((cost < INT_MAX ? cost : INT_MAX) << 31) | v;
+                }
+            qsort(keys, n, sizeof(long long), compareKeys);
+            for (i = 0; i < n && status == SAT; i++) {
+                if (!(i & 63) && wall_clock() - start > this->eliminateSeconds)
+                    break;
+                v = (int) (keys[i] & INT_MAX);
+                if (!this->value[v])
+                    status = eliminateVar(v);
+            }
+            progress = (this->nEliminated > before);
+        }
+        free(keys);
+        this->elimination.seconds += wall_clock() - start;
+        return status;
+    }
+
+    int compactIrredundant() {                            // Store the remaining clauses at the start of DB again
+        int i, used = 1, live = 0;
+        for (i = -this->nVars; this->occs && i <= this->nVars; i++)
+            free(this->occs[i].c);
+        free(this->occs ? this->occs - this->nVars : 0);
+        this->occs = 0;
+        for (i = 0; i < this->nIrredundant; i++) {        // The offsets are increasing, so clauses only move down
+            int offset = this->irredundant[i], size = this->DB[offset] & LBD;
+            if (this->DB[offset] & GARBAGE)
+                continue;
+            memmove(this->DB + used, this->DB + offset, sizeof(int) * (size + 4));
+            this->DB[used] = CLAUSE;
+            this->DB[used + 1] = this->DB[used + 2] = 0;
+            used += size + 4;
+            live++;
+        }
+        free(this->irredundant);
+        this->irredundant = 0;
+        this->nIrredundant = this->irredundantCap = 0;
+        this->mem_used = this->mem_fixed = used;
+        this->nClauses = live;
+        if (!watchClauses(1, this->mem_fixed))
+            return MEMOUT;
+        this->processed = this->mfalseStack;              // Propagate all top-level units over the new watches
+        int status = propagate();
+        if (status == UNSAT)
+            refute();
+        return status;
+    }
+
+    int addCube(int size, int weight) {                   // Store the cube in buffer as [weight, literals, 0]
+        if (this->cubesSize + size + 2 > this->cubesCap) {
+            int cap = 2 * this->cubesCap + size + 2;
+            int* store = (int *) realloc(this->cubes, sizeof(int) * cap);
+            if (!store)
+                return MEMOUT;
+            this->cubes = store;
+            this->cubesCap = cap;
+        }
+        int* cube = this->cubes + this->cubesSize;
+        cube[0] = weight;
+        memcpy(cube + 1, this->buffer, sizeof(int) * size);
+        cube[size + 1] = 0;
+        this->cubesSize += size + 2;
+        this->nCubes++;
+        return SAT;
+    }
+
+    int lookahead(int depth, int size) {                  // Split the node buffer[0..size), which is propagated,
+        int *node = this->assigned, i, sign, best = 0;    // depth more times on the candidate whose two branches
+        long long bestScore = -1;                         // propagate the most: (1 + pos) * (1 + neg)
+        for (i = 0; depth && i < this->nCandidates; i++) {
+            int v = this->candidates[i], count[2], status;
+            for (sign = 0; sign < 2 && !this->value[v]; sign++) {
+                int* before = this->assigned, lit = sign ? -v : v;
+                branch(lit);
+                status = propagate();
+                count[sign] = (int) (this->assigned - before);
+                backtrack(before);
+                if (status == MEMOUT)
+                    return MEMOUT;
+                if (status == CONFLICT) {                 // A failed literal: -lit holds in the whole node
+                    branch(-lit);
+                    if ((status = propagate()) == MEMOUT)
+                        return MEMOUT;
+                    if (status == CONFLICT) {
+                        backtrack(node);                  // Both branches fail, so the node is refuted
+                        this->nRefutedCubes++;
+                        return SAT;
+                    }
+                    break;
+                }
+            }
+            if (sign == 2 && (long long) (1 + count[0]) * (1 + count[1]) > bestScore) {
+                bestScore = (long long) (1 + count[0]) * (1 + count[1]);
+                best = v;
+            }
+        }
+        int status = SAT;
+        if (!best)                                        // A leaf: fewer assigned variables means a harder cube
+            status = addCube(size, (int) (this->assigned - this->mfalseStack));
+        for (sign = 0; best && sign < 2 && status == SAT; sign++) {
+            this->buffer[size] = sign ? -best : best;
+            branch(this->buffer[size]);
+            status = propagate();
+            if (status == CONFLICT) {
+                this->nRefutedCubes++;
+                status = SAT;
+            }
+            else if (status == SAT)
+                status = lookahead(depth - 1, size + 1);
+            backtrack(node);
+        }
+        backtrack(node);
+        return status;
+    }
+
+    int cube(int depth) {                                 // Split the formula into at most 2^depth cubes by lookahead.
+        double start = wall_clock();                      // Returns UNSAT if every branch is refuted, SAT otherwise
+        int i, size, v;
+        if (this->inconsistent)
+            return UNSAT;
+        restart();
+        if (this->nPending && flushPending() != SAT)
+            return this->inconsistent ? UNSAT : MEMOUT;
+        this->resumable = 0;
+        int status = propagate();
+        if (status == UNSAT)
+            return refute();
+        if (status != SAT)
+            return status;
+        long long* keys = (long long *) malloc(sizeof(long long) * (this->nVars + 1));
+        int* occurs = getVars(2 * (this->nVars + 1));     // Occurrences of v at 2 * v and of -v at 2 * v + 1
+        free(this->candidates);
+        this->candidates = getVars(this->lookaheadVars + 1);
+        if (!keys || !occurs || !this->candidates) {
+            free(keys);
+            free(occurs);
+            return MEMOUT;
+        }
+        for (i = 1; i < this->mem_fixed; i += size + 4)
+            for (size = 0; this->DB[i + 3 + size]; size++)
+                occurs[2 * abs(this->DB[i + 3 + size]) + (this->DB[i + 3 + size] < 0)]++;
+        int n = 0;
+        for (v = 1; v <= this->nVars; v++)
+            if (!this->value[v] && !this->eliminated[v]) { // Most occurrences of both signs first
+                long long both = (long long) occurs[2 * v] * occurs[2 * v + 1];
+                keys[n++] = ((INT_MAX - (both < INT_MAX ? both : INT_MAX)) << 31) | v;
+            }
+        qsort(keys, n, sizeof(long long), compareKeys);
+        for (i = 0; i < n && i < this->lookaheadVars; i++)
+            this->candidates[i] = (int) (keys[i] & INT_MAX);
+        this->nCandidates = i;
+        free(occurs);
+
+        this->nCubes = this->cubesSize = this->nRefutedCubes = 0;
+        this->reportConflicts = 1;
+        status = lookahead(depth, 0);
+        this->reportConflicts = 0;
+        restart();
+        if (status == SAT && this->nCubes) {              // Sort the cubes by weight, hardest first
+            long long* order = (long long *) realloc(keys, sizeof(long long) * this->nCubes);
+            int* sorted = (int *) malloc(sizeof(int) * this->cubesSize);
+            if (!order || !sorted) {
+                free(order ? order : keys);
+                free(sorted);
+                return MEMOUT;
+            }
+            keys = order;
+            for (i = n = 0; n < this->nCubes; n++, i += size + 2) {
+                for (size = 0; this->cubes[i + 1 + size]; size++)
+                    ;
+                keys[n] = ((long long) this->cubes[i] << 31) | i;
+            }
+            qsort(keys, this->nCubes, sizeof(long long), compareKeys);
+            for (i = n = 0; n < this->nCubes; n++) {      // The weights are dropped
+                int* cube = this->cubes + (keys[n] & INT_MAX) + 1;
+                while (*cube)
+                    sorted[i++] = *(cube++);
+                sorted[i++] = 0;
+            }
+            free(this->cubes);
+            this->cubes = sorted;
+            this->cubesSize = this->cubesCap = i;
+        }
+        free(keys);
+        this->lookaheadSeconds += wall_clock() - start;
+        if (status == SAT && !this->nCubes)
+            return refute();                              // Lookahead refuted every branch
+        return status;
+    }
+
+    int writeICNF(const char* filename) {                 // Write the clauses and the cubes in the iCNF format,
+        FILE* out = fopen(filename, "w");                 // returns 0 on failure
+        if (!out)
+            return 0;
+        int i, size, *p;
+        fprintf(out, "p inccnf\n");
+        for (p = this->mfalseStack; p < this->forced; p++)
+            fprintf(out, "%i 0\n", -*p);                  // The top-level units
+        for (i = 1; i < this->mem_fixed; i += size + 4) {
+            for (size = 0; this->DB[i + 3 + size]; size++)
+                fprintf(out, "%i ", this->DB[i + 3 + size]);
+            fprintf(out, "0\n");
+        }
+        for (p = this->cubes, i = 0; i < this->nCubes; i++) {
+            fprintf(out, "a");
+            while (*p)
+                fprintf(out, " %i", *(p++));
+            fprintf(out, " 0\n");
+            p++;
+        }
+        return !ferror(out) & !fclose(out);
+    }
+
+    int preprocess() {                                    // Simplify the irredundant clauses at the top level
+        if (this->inconsistent)
+            return UNSAT;
+        restart();
+        if (this->nPending && flushPending() != SAT)
+            return this->inconsistent ? UNSAT : MEMOUT;
+        this->resumable = 0;
+        int status = probe();
+        if (status != SAT)
+            return status;
+        status = collect();                               // From here on the passes stop at the first failure,
+        if (status == SAT)                                // but the clauses are always put back into place
+            status = subsume();
+        if (status == SAT)
+            status = eliminate();
+        int compacted = compactIrredundant();
+        if (this->inconsistent)
+            return UNSAT;
+        return (status != SAT) ? status : compacted;
+    }
+
+    void extendModel() {                                  // Give the eliminated variables values that satisfy the
+        int* p = this->extension + this->nExtension;      // clauses removed with them, in reverse order
+        while (p > this->extension) {
+            int *end = --p, satisfied = 0, *q;
+            while (p > this->extension && p[-1])
+                p--;
+            for (q = p; q < end && !satisfied; q++)
+                satisfied = (this->model[abs(*q)] == (*q > 0));
+            if (!satisfied)
+                this->model[abs(*p)] = (*p > 0);          // Make the witness true
+        }
+    }
+
+    int mentionsEliminated(const int* assume, int n) {    // Do the assumptions or new clauses use an eliminated variable?
+        int i;
+        for (i = 0; i < n; i++)
+            if (abs(assume[i]) <= this->nVars && this->eliminated[abs(assume[i])])
+                return 1;
+        for (i = 0; i < this->nPending; i++)
+            if (this->eliminated[abs(this->pending[i])])
+                return 1;
+        return 0;
+    }
+
+    int restoreEliminated() {                             // Add the clauses removed by elimination again
+        int i, v;
+        for (i = 0; i < this->nExtension; i++)
+            if (add(this->extension[i]) != SAT)
+                return MEMOUT;
+        for (v = 1; v <= this->nVars; v++)
+            if (this->eliminated[v]) {                    // Put v back in the decision order
+                this->eliminated[v] = 0;
+                this->prev[v] = this->head;
+                this->next[this->head] = v;
+                this->head = v;
+                this->bumped[v] = ++this->nBumps;
+                if (!this->heapPos[v])
+                    heapInsert(v);
+            }
+        this->nEliminated = this->nExtension = 0;
+        return SAT;
+    }
+
+
+    int parseError(const char* message, int line) {               // Record why the input was rejected
+        this->error = message;
+        this->error_line = line;
+        return PARSE_ERROR;
+    }
+
+    int parse(const char* filename) {                                   // Parse the formula and initialize
+        micro_input input;
+        this->error = 0;
+        this->error_line = 0;
+        if (!input.open(filename))
+            return parseError("cannot read input file", 0);
+        return parse(input.data, input.size);
+    }
+
+    int parse(const char* data, size_t bytes) {                         // Parse DIMACS text held in memory (the solver
+        STAT(double started = wall_clock());                            // may hold an earlier formula, whose storage
+        this->error = 0;                                                // is reused)
+        this->error_line = 0;
+        this->parsed_bytes = bytes;
+        const char *p = data, *end = p + bytes;
+        int line = 1;
+
+        for (;;) {                                                      // Skip the comments before the header
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+                if (*(p++) == '\n')
+                    line++;
+            if (p == end || *p != 'c')
+                break;
+            while (p < end && *p != '\n')
+                p++;
+        }
+        long long header[2];
+        if (p == end || *(p++) != 'p')
+            return parseError("missing 'p cnf' header", line);
+        while (p < end && (*p == ' ' || *p == '\t'))
+            p++;
+        if (end - p < 3 || memcmp(p, "cnf", 3))
+            return parseError("missing 'p cnf' header", line);
+        p += 3;
+        int h;
+        for (h = 0; h < 2; h++) {                                       // Read the number of variables and clauses
+            while (p < end && (*p == ' ' || *p == '\t'))
+                p++;
+            if (p == end || *p < '0' || *p > '9')
+                return parseError("invalid 'p cnf' header", line);
+            for (header[h] = 0; p < end && *p >= '0' && *p <= '9'; p++)
+                if ((header[h] = 10 * header[h] + (*p - '0')) >= INT_MAX / 2)
+                    return parseError("header value too large", line);
+        }
+        while (p < end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+        if (p < end && *p != '\n')
+            return parseError("unexpected text after 'p cnf' header", line);
+
+        if (initCDCL((int) header[0], (int) header[1]) == MEMOUT)      // Allocate the main datastructures
+            return MEMOUT;
+        int n = (int) header[0];
+        int nRead = 0, size = 0, taut = 0, result = SAT;
+        while (result == SAT) {                                         // Tokenize the remaining bytes by hand
+            while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n'))
+                if (*(p++) == '\n')
+                    line++;
+            if (p == end)
+                break;
+            if (*p == '%')                                              // The SATLIB end marker (followed by a 0)
+                break;
+            if (*p == 'c') {                                            // Skip comments
+                while (p < end && *p != '\n')
+                    p++;
+                continue;
+            }
+            int sign = 1;
+            if (*p == '-') {
+                sign = -1;
+                p++;
+            }
+            if (p == end || *p < '0' || *p > '9') {
+                result = parseError("expected a literal", line);
+                break;
+            }
+            long long var = 0;
+            while (p < end && *p >= '0' && *p <= '9' && var <= n)
+                var = 10 * var + (*(p++) - '0');
+            if (var > n) {
+                result = parseError("literal exceeds the number of variables", line);
+                break;
+            }
+            int lit = sign * (int) var;
+            if (lit) {                                                  // Drop duplicate literals and remember tautologies
+                int i = 0, v = abs(lit), mark = 2 * (this->stamp + 1);   // Long clauses are checked using the stamps
+                if (size >= 8) {                                        // in marks (mark + 1 for a positive literal)
+                    if (size == 8)
+                        for (i = 0; i < size; i++)
+                            this->marks[abs(this->buffer[i])] = mark + (this->buffer[i] > 0);
+                    i = (this->marks[v] == mark || this->marks[v] == mark + 1) ? 0 : size;
+                    this->marks[v] = mark + (lit > 0);
+                }
+                while (i < size && this->buffer[i] != lit && this->buffer[i] != -lit)
+                    i++;
+                if (i == size)
+                    this->buffer[size++] = lit;                         // Add literal to buffer
+                else if (this->buffer[i] == -lit)
+                    taut = 1;
+                continue;
+            }
+            if (++nRead > this->nClauses)
+                result = parseError("more clauses than declared in the header", line);
+            else if (!taut) {                                           // Tautologies are simply skipped
+                int* clause = addClause(this->buffer, size, 1);         // Then add the clause to data_base
+                if (!clause)
+                    result = MEMOUT;
+                else if (!size || ((size == 1) && this->value[clause[0]] < 0)) // Check for empty clause or conflicting unit
+                    result = refute();                                  // If either is found return UNSAT
+                else if ((size == 1) && this->value[clause[0]] <= 0)    // Check for a new unit
+                    assign(clause, 1);                                  // Directly assign new units (forced = 1)
+            }
+            size = taut = 0;
+            this->stamp++;                                              // A new stamp for the next clause
+        }
+        this->forced = this->assigned;                                  // The units are top-level assignments
+        if (result == SAT && size)
+            return parseError("last clause is not terminated by 0", line);
+        if (result == SAT && nRead < this->nClauses)
+            return parseError("fewer clauses than declared in the header", line);
+        STAT(this->stats.parse = wall_clock() - started);
+        return result;                                                  // Return whether a conflict was observed
+    }
+};
+
+struct micro_portfolio {                                            // Diversified solvers racing on the same formula
+    struct job {
+        micro_portfolio *portfolio;
+        int id;
+    };
+
+    micro_solver *solvers;
+    int nSolvers;
+    const char *data;                                               // The input, read once for all the solvers
+    size_t size;
+    int nFailed;                                                    // Solvers 1.. that could not parse it (memory)
+    int done;                                                       // Set by the first answer or interrupt; cancels the others
+    int winner;                                                     // Index of the solver that answered first
+    int result;
+    int preprocess;                                                 // Preprocess the formula in every thread
+    micro_exchange *exchange;
+    const int *cubes;                                               // Cube mode: the solvers take these cubes (each
+    int nCubes;                                                     // ended by 0) and solve under their assumptions,
+    const char *queue;                                              // or take the cube files in this directory
+    int *starts;                                                    // Offsets of the cubes in memory
+    int nextCube;
+    int nRefuted;                                                   // Cubes shown to be unsatisfiable
+    int nUnknown;                                                   // Cubes given up on (budget or interrupt)
+    int satCube;                                                    // Number of the satisfiable cube
+    int finished;                                                   // Threads that have stopped
+
+    micro_portfolio(int n, int share) : nSolvers(n), data(0), size(0), nFailed(0), done(0), winner(-1), result(micro_solver::UNKNOWN),
+                                        preprocess(0), cubes(0), nCubes(0), queue(0), starts(0), nextCube(0),
+                                        nRefuted(0), nUnknown(0), satCube(-1), finished(0) {
+        this->solvers = new micro_solver[n];
+        this->exchange = share ? new micro_exchange : 0;
+    }
+
+    ~micro_portfolio() {
+        delete[] this->solvers;
+        delete this->exchange;
+        free(this->starts);
+    }
+
+    // A queue directory holds one file per cube, NNNNNNNN.cube with an iCNF "a ... 0" line, numbered hardest
+    // first, and a file total with their number. A worker claims a cube by renaming it to NNNNNNNN.HOST.PID.ID,
+    // then renames it to NNNNNNNN.unsat, or back to NNNNNNNN.cube if it gave up. A satisfiable cube is copied to
+    // the file SAT, which stops all workers. rename is atomic, so the directory may be shared by several machines.
+
+    static int enqueue(const char* dir, const int* cubes, int n) { // Write the cubes as a queue, returns 0 on failure
+        char name[4096], tmp[4096];
+        int i;
+        if (mkdir(dir, 0777) && errno != EEXIST)
+            return 0;
+        for (i = 0; i <= n; i++) {
+            snprintf(tmp, sizeof(tmp), "%s/%08i.tmp", dir, i);
+            FILE* out = fopen(tmp, "w");                         // Workers never see partly written cubes
+            if (!out)
+                return 0;
+            if (i == n)
+                fprintf(out, "%i\n", n);
+            else {
+                fprintf(out, "a");
+                while (*cubes)
+                    fprintf(out, " %i", *(cubes++));
+                fprintf(out, " 0\n");
+                cubes++;
+            }
+            if (ferror(out) | fclose(out))
+                return 0;
+            if (i == n)
+                snprintf(name, sizeof(name), "%s/total", dir);
+            else
+                snprintf(name, sizeof(name), "%s/%08i.cube", dir, i);
+            if (rename(tmp, name))
+                return 0;
+        }
+        return 1;
+    }
+
+    int claim(int id, char* claimed, int** lits) {          // Take the hardest cube left in the queue, returns its
+        char best[256], name[4096], host[64];                // size, or -1 if there is none (or on an error)
+        for (;;) {
+            DIR* dir = opendir(this->queue);
+            if (!dir)
+                return -1;
+            struct dirent* entry;
+            best[0] = 0;
+            while ((entry = readdir(dir)))
+                if (strlen(entry->d_name) == 13 && !strcmp(entry->d_name + 8, ".cube") &&
+                    (!best[0] || strcmp(entry->d_name, best) < 0))
+                    strcpy(best, entry->d_name);
+            closedir(dir);
+            if (!best[0])
+                return -1;
+            if (gethostname(host, sizeof(host)))
+                strcpy(host, "localhost");
+            host[sizeof(host) - 1] = 0;
+            snprintf(name, sizeof(name), "%s/%s", this->queue, best);
+            snprintf(claimed, 4096, "%s/%.8s.%s.%i.%i", this->queue, best, host, (int) getpid(), id);
+            if (rename(name, claimed)) {
+                if (errno == ENOENT)
+                    continue;                                // Another worker was faster
+                fprintf(stderr, "c error: cannot claim %s: %s\n", name, strerror(errno));
+                return -1;
+            }
+            FILE* in = fopen(claimed, "r");
+            int size = 0, cap = 16, lit, ok;
+            *lits = (int *) malloc(sizeof(int) * cap);
+            ok = in && *lits && fgetc(in) == 'a';
+            while (ok && fscanf(in, "%i", &lit) == 1 && lit) {
+                if (size == cap) {
+                    int* store = (int *) realloc(*lits, sizeof(int) * (cap *= 2));
+                    if (!(ok = (store != 0)))
+                        break;
+                    *lits = store;
+                }
+                (*lits)[size++] = lit;
+            }
+            if (in)
+                fclose(in);
+            if (!ok) {
+                rename(claimed, name);                       // Put the cube back for another worker
+                return -1;
+            }
+            return size;
+        }
+    }
+
+    int release(const char* claimed, int status) {          // Record the answer for a claimed cube, returns UNSAT if
+        char name[4096];                                     // this was the last cube of the queue to be refuted
+        snprintf(name, sizeof(name), "%s/%.8s", this->queue, claimed + strlen(this->queue) + 1);
+        if (status == micro_solver::SAT) {
+            snprintf(name, sizeof(name), "%s/SAT", this->queue);
+            link(claimed, name);
+            return status;
+        }
+        strcat(name, (status == micro_solver::UNSAT) ? ".unsat" : ".cube");
+        if (rename(claimed, name) || status != micro_solver::UNSAT)
+            return micro_solver::UNKNOWN;
+        int total = -1, refuted = 0;
+        snprintf(name, sizeof(name), "%s/total", this->queue);
+        FILE* in = fopen(name, "r");
+        if (in) {
+            if (fscanf(in, "%i", &total) != 1)
+                total = -1;
+            fclose(in);
+        }
+        DIR* dir = opendir(this->queue);
+        struct dirent* entry;
+        while (dir && (entry = readdir(dir)))
+            refuted += (strlen(entry->d_name) == 14 && !strcmp(entry->d_name + 8, ".unsat"));
+        if (dir)
+            closedir(dir);
+        return (refuted == total) ? micro_solver::UNSAT : micro_solver::UNKNOWN;
+    }
+
+    void interrupt() {                                              // Stop the solvers, also those that start later
+        __atomic_store_n(&this->done, 1, __ATOMIC_RELEASE);
+    }
+
+    int stopped() {                                         // Another thread or worker found a satisfiable cube
+        char name[4096];
+        if (__atomic_load_n(&this->done, __ATOMIC_ACQUIRE))
+            return 1;
+        snprintf(name, sizeof(name), "%s/SAT", this->queue ? this->queue : ".");
+        return this->queue && !access(name, F_OK);
+    }
+
+    int conquer(micro_solver* S, int id, int* cube) {      // Solve cubes until one is satisfiable (SAT, and its
+        for (;;) {                                          // number in cube), the last is refuted or the formula
+            char claimed[4096];                             // is (UNSAT), or none is left
+            int *lits = 0, size = -1, index = -1, last = 0;
+            if (stopped())
+                return micro_solver::UNKNOWN;
+            if (this->queue)
+                size = claim(id, claimed, &lits);
+            else if ((index = __atomic_fetch_add(&this->nextCube, 1, __ATOMIC_RELAXED)) < this->nCubes) {
+                lits = (int *) this->cubes + this->starts[index];
+                for (size = 0; lits[size]; size++)
+                    ;
+            }
+            if (size < 0) {
+                if (this->queue)
+                    free(lits);
+                return micro_solver::UNKNOWN;
+            }
+            int status = S->solve(lits, size);
+            if (status == micro_solver::UNSAT && !S->inconsistent) {
+                int refuted = __atomic_add_fetch(&this->nRefuted, 1, __ATOMIC_ACQ_REL);
+                last = this->queue ? (release(claimed, status) == micro_solver::UNSAT) : (refuted == this->nCubes);
+            }
+            else if (this->queue)
+                release(claimed, status);                   // Publish SAT, or put the cube back
+            if (this->queue)
+                free(lits);
+            if (status == micro_solver::SAT)
+                *cube = index;
+            else if (status != micro_solver::UNSAT)
+                __atomic_add_fetch(&this->nUnknown, 1, __ATOMIC_RELAXED);
+            else if (!S->inconsistent && !last)
+                continue;
+            return status;                                  // Out of budget, or interrupted: stop this thread
+        }
+    }
+
+    void configure(int id) {                                        // Solver 0 keeps the defaults, the others vary
+        static const int ratios[] = {60, 50, 70, 80, 55, 65, 75, 45};
+        micro_solver* S = &this->solvers[id];
+        S->terminate = &this->done;
+        S->exchange = this->exchange;
+        S->shareId = id;
+        if (!id)
+            return;
+        S->restartRatio = ratios[id % 8];                           // Restart thresholds
+        S->tier2LBD = 5 + id % 3;                                   // reduceDB parameters
+        S->maxLemmas = 2000 + 1000 * (id % 4);
+        S->lemmaStep = 200 + 100 * (id % 3);
+        S->heuristic = (id % 2) ? micro_solver::VSIDS : micro_solver::MTF; // Decision heuristics
+        S->diversify(0x9e3779b9u * id, id % 3);                     // Initial phases and decision order
+    }
+
+    static void* run(void* arg) {                                   // Thread body: parse (except solver 0), then solve
+        micro_portfolio* P = ((job *) arg)->portfolio;
+        int id = ((job *) arg)->id, result = micro_solver::SAT, cube = -1;
+        micro_solver* S = &P->solvers[id];
+        if (id)
+            result = S->parse(P->data, P->size);
+        if (id && result != micro_solver::SAT && result != micro_solver::UNSAT)
+            __atomic_add_fetch(&P->nFailed, 1, __ATOMIC_RELAXED);
+        if (id && result == micro_solver::SAT && P->preprocess)
+            result = S->preprocess();                               // Lemmas on eliminated variables are not imported
+        if (result == micro_solver::SAT) {
+            P->configure(id);
+            result = (P->cubes || P->queue) ? P->conquer(S, id, &cube) : S->solve();
+        }
+        int none = -1;
+        if ((result == micro_solver::SAT || result == micro_solver::UNSAT) &&
+            __atomic_compare_exchange_n(&P->winner, &none, id, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE)) {
+            P->result = result;                                     // The first answer wins
+            P->satCube = cube;                                      // (with its cube, if it came from one)
+            __atomic_store_n(&P->done, 1, __ATOMIC_RELEASE);
+        }
+        __atomic_add_fetch(&P->finished, 1, __ATOMIC_RELEASE);
+        return 0;
+    }
+
+    int solve(const char* data, size_t size) {                      // Solvers 1.. parse the input in their own thread
+        int i;
+        this->data = data;
+        this->size = size;
+        pthread_t* threads = (pthread_t *) malloc(sizeof(pthread_t) * this->nSolvers);
+        job* jobs = (job *) malloc(sizeof(job) * this->nSolvers);
+        this->starts = (int *) malloc(sizeof(int) * (this->nCubes + 1));
+        if (!threads || !jobs || !this->starts) {
+            free(threads);
+            free(jobs);
+            return micro_solver::MEMOUT;
+        }
+        int offset = 0;
+        for (i = 0; i < this->nCubes; i++) {                        // Index the cubes in memory
+            this->starts[i] = offset;
+            while (this->cubes[offset++])
+                ;
+        }
+        for (i = 0; i < this->nSolvers; i++) {
+            jobs[i].portfolio = this;
+            jobs[i].id = i;
+            if (pthread_create(&threads[i], 0, run, &jobs[i]))
+                break;                                              // Run with fewer threads if the system refuses more
+        }
+        int started = i;
+        while (this->queue && __atomic_load_n(&this->finished, __ATOMIC_ACQUIRE) < started)
+            if (stopped())                                          // A worker elsewhere found a satisfiable cube
+                __atomic_store_n(&this->done, 1, __ATOMIC_RELEASE);
+            else
+                usleep(100000);
+        for (i = 0; i < started; i++)
+            pthread_join(threads[i], 0);
+        free(threads);
+        free(jobs);
+        return this->result;
+    }
+};
+
+struct micro_batch {                                                // A pool of threads solving independent formulas
+    struct job {
+        micro_batch *batch;
+        int id;
+    };
+
+    micro_solver *solvers;                                          // One per thread, reused for all its queries
+    int nSolvers;
+    microsat_query *queries;
+    int nQueries;
+    int nextQuery;
+    int preprocess;                                                 // Preprocess each formula before solving it
+    int done;                                                       // Set by interrupt: stop taking queries
+    microsat_answer answer;                                         // Called after each query, if set
+    void *arg;
+
+    micro_batch(int n) : nSolvers(n), queries(0), nQueries(0), nextQuery(0), preprocess(0), done(0), answer(0),
+                         arg(0) {
+        this->solvers = new micro_solver[n];
+        for (int i = 0; i < n; i++)
+            this->solvers[i].terminate = &this->done;
+    }
+
+    ~micro_batch() {
+        delete[] this->solvers;
+    }
+
+    void interrupt() {                                              // Give up the running and the remaining queries
+        __atomic_store_n(&this->done, 1, __ATOMIC_RELEASE);
+    }
+
+    static void* run(void* arg) {                                   // Thread body: take queries until none is left
+        micro_batch* B = ((job *) arg)->batch;
+        micro_solver* S = &B->solvers[((job *) arg)->id];
+        for (;;) {
+            int i = __atomic_fetch_add(&B->nextQuery, 1, __ATOMIC_RELAXED);
+            if (i >= B->nQueries || __atomic_load_n(&B->done, __ATOMIC_ACQUIRE))
+                return 0;
+            microsat_query* q = &B->queries[i];
+            int result = q->file ? S->parse(q->file) : S->parse(q->data, q->size); // Reuses the storage of S
+            if (result == micro_solver::SAT && B->preprocess)
+                result = S->preprocess();
+            if (result == micro_solver::SAT)
+                result = S->solve();
+            q->result = result;
+            if (B->answer)
+                B->answer(q, S, B->arg);
+        }
+    }
+
+    int solve(microsat_query* queries, int n) {                     // Returns the number of SAT and UNSAT answers
+        int i, answered = 0;
+        this->queries = queries;
+        this->nQueries = n;
+        this->nextQuery = 0;
+        for (i = 0; i < n; i++)
+            queries[i].result = micro_solver::UNKNOWN;
+        pthread_t* threads = (pthread_t *) malloc(sizeof(pthread_t) * this->nSolvers);
+        job* jobs = (job *) malloc(sizeof(job) * this->nSolvers);
+        if (!threads || !jobs) {
+            free(threads);
+            free(jobs);
+            return micro_solver::MEMOUT;
+        }
+        for (i = 0; i < this->nSolvers; i++) {
+            jobs[i].batch = this;
+            jobs[i].id = i;
+            if (pthread_create(&threads[i], 0, run, &jobs[i]))
+                break;                                              // Run with fewer threads if the system refuses more
+        }
+        int started = i;
+        if (!started)
+            run(&jobs[0]);                                          // or in this thread if it refuses all
+        for (i = 0; i < started; i++)
+            pthread_join(threads[i], 0);
+        free(threads);
+        free(jobs);
+        for (i = 0; i < n; i++)
+            answered += (queries[i].result == micro_solver::SAT || queries[i].result == micro_solver::UNSAT);
+        return answered;
+    }
+};
+
+micro_solver* microsat_create(void) {
+    return new (std::nothrow) micro_solver;
+}
+
+void microsat_reset(micro_solver* S) {
+    if (S->DB)
+        S->initCDCL(0, 0);                                          // An empty formula, in the old storage
+}
+
+void microsat_destroy(micro_solver* S) {
+    delete S;
+}
+
+int microsat_parse(micro_solver* S, const char* data, size_t size) {
+    return S->parse(data, size);
+}
+
+int microsat_parse_file(micro_solver* S, const char* filename) {
+    return S->parse(filename);
+}
+
+const char* microsat_error(const micro_solver* S, int* line) {
+    if (line)
+        *line = S->error_line;
+    return S->error;
+}
+
+int microsat_add(micro_solver* S, int lit) {
+    if (!S->DB && S->initCDCL(0, 0) != micro_solver::SAT)         // A solver that was never parsed starts empty
+        return micro_solver::MEMOUT;
+    return S->add(lit);
+}
+
+int microsat_solve(micro_solver* S, const int* assumptions, int n) {
+    if (!S->DB && S->initCDCL(0, 0) != micro_solver::SAT)
+        return micro_solver::MEMOUT;
+    return S->solve(assumptions, n);
+}
+
+int microsat_val(micro_solver* S, int lit) {
+    return S->val(lit);
+}
+
+int microsat_failed(micro_solver* S, int lit) {
+    return S->failed(lit);
+}
+
+void microsat_limit(micro_solver* S, int conflicts, double seconds) {
+    S->maxconflicts = conflicts > 0 ? conflicts : INT_MAX;
+    S->maxSeconds = seconds;
+}
+
+void microsat_interrupt(micro_solver* S) {
+    S->interrupt();
+}
+
+int microsat_batch(microsat_query* queries, int n, int threads, int conflicts, double seconds,
+                   microsat_answer answer, void* arg) {
+    micro_batch B(threads > 0 ? threads : 1);
+    for (int i = 0; i < B.nSolvers; i++)
+        microsat_limit(&B.solvers[i], conflicts, seconds);
+    B.answer = answer;
+    B.arg = arg;
+    return B.solve(queries, n);
+}
+
+#ifdef STANDALONE
+
+static const char* usage =
+    "c usage: %s [OPTION]... FILE   (FILE may be gzip/xz compressed, or - for stdin)\n"
+    "c        %s [OPTION]... --bench=DIR [--json]\n"
+    "c        %s [OPTION]... --batch=LIST\n"
+    "c   --engine=blocker|linked  propagate over watch vectors with blockers (default) or linked watch lists\n"
+    "c   --heuristic=mtf|vmtf|vsids  decide by move-to-front (default), move-to-front with a cached search\n"
+    "c                            position, or by activity on a binary heap\n"
+    "c   --threads=N              run a portfolio of N diversified solvers, the first answer wins\n"
+    "c   --no-share               do not exchange short lemmas between the portfolio solvers\n"
+    "c   --preprocess             probe failed literals, remove subsumed clauses and eliminate variables first\n"
+    "c   --conflicts=N            give up after N conflicts\n"
+    "c   --time=SECONDS           give up after SECONDS of search (SIGINT gives up at once)\n"
+    "c   --memory=MB              give up when the clause database outgrows MB after reduction\n"
+    "c   --progress=SECONDS       print a progress line every SECONDS during the search\n"
+    "c   --vivify=PERCENT         spend up to PERCENT of the propagations shortening lemmas (default 10, 0 = off)\n"
+    "c   --cube=DEPTH             split the formula by lookahead into at most 2^DEPTH cubes and solve them under\n"
+    "c                            assumptions on --threads, hardest first, until one is satisfiable\n"
+    "c   --icnf=FILE              with --cube: only write the formula and the cubes to FILE in the iCNF format\n"
+    "c   --queue=DIR              with --cube: only write the cubes as a job queue to DIR\n"
+    "c   --worker=DIR             solve the cubes of the job queue in DIR, which any number of workers may share\n"
+    "c   --proof=FILE             write a DRAT proof of unsatisfiability to FILE (single thread only)\n"
+    "c   --binary-proof           write the proof in binary DRAT instead of text\n"
+    "c   --bench=DIR              solve every file in DIR with a timeout (--time, default 60) and print\n"
+    "c                            one CSV line per file, with the solved count and PAR-2 score on stderr\n"
+    "c   --json                   print the benchmark results as a JSON object instead\n"
+    "c   --batch=LIST             solve the files named in LIST (one per line, - for stdin) on a pool of --threads\n"
+    "c                            reused solvers, with the budgets per file, and print one CSV line per file\n";
+
+struct options {
+    int engine = micro_solver::BLOCKER;
+    int heuristic = micro_solver::MTF;
+    int threads = 1;
+    int share = 1;
+    int preprocess = 0;
+    int conflicts = INT_MAX;
+    double seconds = 0;
+    double megabytes = 0;
+    double progress = 0;
+    int vivify = 10;
+    int cube = 0;                                                       // Lookahead depth of cube mode
+    const char *icnf = 0;                                               // Write the cubes here (iCNF) or
+    const char *queue = 0;                                              // to this job queue instead of solving them
+    const char *worker = 0;                                             // Solve the cubes from this job queue
+    const char *proof = 0;                                              // DRAT proof file, if any
+    int binaryProof = 0;
+    int verbose = 1;                                                    // Print comments, statistics and the model
+};
+
+struct outcome {                                                        // What the benchmark driver records per file
+    int result;
+    double seconds;
+    int conflicts;
+    long long propagations;
+};
+
+static micro_portfolio* running = 0;
+static micro_batch* batching = 0;
+static volatile sig_atomic_t stopped = 0;
+
+static void interrupt_handler(int) {                                    // Ctrl-C reports UNKNOWN instead of killing us
+    stopped = 1;
+    if (running)
+        running->interrupt();
+    if (batching)
+        batching->interrupt();
+}
+
+static void printStatistics(micro_solver* S) {
+#ifdef MICROSAT_STATS
+    printf("c %lld decisions, %lld watch visits, %lld restarts, %lld reductions, %lld imports\n", S->stats.decisions,
+           S->stats.visits, S->stats.restarts, S->stats.reductions, S->stats.imports);
+    printf("c parse %.2f, propagate %.2f (analyze %.2f), reduce %.2f seconds\n", S->stats.parse, S->stats.propagate,
+           S->stats.analyze, S->stats.reduce);
+#endif
+    if (S->vivification.clauses || S->minimization.literals)
+        printf("c vivification removed %i literals from %i lemmas in %.2f seconds, binary minimization %i literals\n",
+               S->vivification.literals, S->vivification.clauses, S->vivification.seconds, S->minimization.literals);
+}
+
+static int solveFile(const char* file, const options& o, outcome* out) { // Parse, preprocess and solve one formula
+    int i;
+    micro_portfolio P(o.threads, o.threads > 1 && o.share);
+    micro_solver* S = &P.solvers[0];
+    for (i = 0; i < o.threads; i++) {
+        P.solvers[i].engine = o.engine;
+        P.solvers[i].heuristic = o.heuristic;
+        P.solvers[i].maxconflicts = o.conflicts;
+        P.solvers[i].maxSeconds = o.seconds;
+        P.solvers[i].maxMemory = (long long) (o.megabytes * 1e6);
+        P.solvers[i].vivifyEffort = o.vivify;
+    }
+    S->progressSeconds = o.verbose ? o.progress : 0;
+    S->terminate = &P.done;                                             // Ctrl-C may come before solve
+    micro_proof proof;
+    if (o.proof && !proof.open(o.proof, o.binaryProof)) {
+        fprintf(o.verbose ? stdout : stderr, "c error: cannot write proof to %s\n", o.proof);
+        return micro_solver::PARSE_ERROR;
+    }
+    if (o.proof)
+        S->proof = &proof;
+    running = &P;
+    double start = wall_clock();
+    micro_input input;                                                  // Read (or decompress) once for all the solvers
+    int result = input.open(file) ? S->parse(input.data, input.size) : S->parseError("cannot read input file", 0);
+    double parsed = wall_clock() - start;
+    if (result == micro_solver::PARSE_ERROR) {
+        fprintf(o.verbose ? stdout : stderr, "c error: %s:%i: %s\n", file, S->error_line, S->error);
+        running = 0;
+        return result;
+    }
+    if (result != micro_solver::MEMOUT && o.verbose)
+        printf("c parsed %i variables and %i clauses (%.1f MB) in %.2f seconds, %.1f MB/s\n", S->nVars, S->nClauses,
+               S->parsed_bytes / 1e6, parsed, parsed > 0 ? S->parsed_bytes / 1e6 / parsed : 0);
+    if (result == micro_solver::SAT && o.preprocess) {
+        P.preprocess = 1;
+        result = S->preprocess();
+        const char* names[] = {"probing", "subsumption", "elimination"};
+        const micro_solver::pass* passes[] = {&S->probing, &S->subsumption, &S->elimination};
+        for (i = 0; i < 3 && o.verbose; i++)
+            printf("c %-11s removed %i variables, %i clauses and %i literals in %.2f seconds\n", names[i],
+                   passes[i]->variables, passes[i]->clauses, passes[i]->literals, passes[i]->seconds);
+    }
+    if (result == micro_solver::SAT && o.cube) {
+        result = S->cube(o.cube);
+        if (o.verbose)
+            printf("c lookahead made %i cubes (and refuted %i branches) in %.2f seconds\n", S->nCubes,
+                   S->nRefutedCubes, S->lookaheadSeconds);
+        if (result == micro_solver::SAT && (o.icnf || o.queue)) {
+            running = 0;
+            if (o.icnf ? !S->writeICNF(o.icnf) : !micro_portfolio::enqueue(o.queue, S->cubes, S->nCubes)) {
+                fprintf(o.verbose ? stdout : stderr, "c error: cannot write the cubes to %s\n", o.icnf ? o.icnf : o.queue);
+                return micro_solver::PARSE_ERROR;
+            }
+            if (o.verbose)
+                printf("c wrote %i cubes to %s\n", S->nCubes, o.icnf ? o.icnf : o.queue);
+            return micro_solver::UNKNOWN;
+        }
+        P.cubes = S->cubes;
+        P.nCubes = S->nCubes;
+    }
+    P.queue = o.worker;
+    fflush(stdout);
+    if (result == micro_solver::SAT && o.threads == 1 && !P.cubes && !P.queue)
+        result = S->solve();
+    else if (result == micro_solver::SAT) {
+        result = P.solve(input.data, input.size);                       // Solver 0 is parsed, the others parse in parallel
+        if (o.verbose && P.nFailed)
+            printf("c %i of %i solvers ran out of memory while parsing\n", P.nFailed, o.threads);
+        long long shared = 0;
+        for (i = 0; i < o.threads; i++)
+            shared += P.solvers[i].nImported;
+        if (P.winner >= 0)
+            S = &P.solvers[P.winner];
+        if (o.verbose && (P.cubes || P.queue))
+            printf("c %i cubes refuted and %i given up by %i threads, %lld lemmas imported\n", P.nRefuted, P.nUnknown,
+                   o.threads, shared);
+        else if (o.verbose)
+            printf("c solver %i of %i answered first, %lld lemmas imported\n", P.winner, o.threads, shared);
+        if (o.verbose && P.satCube >= 0) {
+            printf("c satisfiable cube %i:", P.satCube);
+            for (i = P.starts[P.satCube]; P.cubes[i]; i++)
+                printf(" %i", P.cubes[i]);
+            printf("\n");
+        }
+    }
+    running = 0;
+    if (o.proof && !proof.close()) {
+        fprintf(o.verbose ? stdout : stderr, "c error: writing the proof to %s failed\n", o.proof);
+        result = micro_solver::UNKNOWN;                                 // Do not claim UNSAT without a certificate
+    }
+    else if (o.proof && o.verbose)
+        printf("c proof: %lld lemmas and %lld deletions, %.1f MB\n", proof.added, proof.deleted, proof.bytes / 1e6);
+    out->result = result;
+    out->seconds = wall_clock() - start;
+    out->conflicts = S->nConflicts;
+    out->propagations = S->nPropagations;
+    if (!o.verbose)
+        return result;
+
+    if (result == micro_solver::MEMOUT || result == micro_solver::UNKNOWN) {
+        printf("c %s after %i conflicts, %.2f seconds\n", result == micro_solver::MEMOUT ? "out of memory" :
+               "no answer", S->nConflicts, out->seconds);
+        printStatistics(S);
+        printf("s UNKNOWN\n");
+        return result;
+    }
+    double solved = out->seconds - parsed;
+    printf("c %i conflicts, %i lemmas, %lld propagations (%.1f M/s), peak arena %.1f MB, %.2f seconds\n",
+           S->nConflicts, S->nLemmas, S->nPropagations, solved > 0 ? S->nPropagations / 1e6 / solved : 0,
+           S->mem_peak * sizeof(int) / 1e6, out->seconds);
+    printStatistics(S);
+    if (result == micro_solver::UNSAT) {
+        printf("s UNSATISFIABLE\n");
+        return result;
+    }
+    printf("s SATISFIABLE\n");
+    int column = printf("v");
+    for (i = 1; i <= S->nVars + 1; i++) {                               // Print the model in lines of at most 78 characters
+        char lit[16];
+        int len = sprintf(lit, " %i", i > S->nVars ? 0 : S->model[i] ? i : -i);
+        if (column + len > 78)
+            column = printf("\nv") - 1;
+        column += printf("%s", lit);
+    }
+    printf("\n");
+    return result;
+}
+
+static const char* resultName(int result) {
+    return result == micro_solver::SAT ? "SAT" : result == micro_solver::UNSAT ? "UNSAT" :
+           result == micro_solver::PARSE_ERROR ? "ERROR" : "UNKNOWN";
+}
+
+static int compareNames(const void* a, const void* b) {
+    return strcmp(*(char * const *) a, *(char * const *) b);
+}
+
+static void printJsonString(const char* s) {
+    putchar('"');
+    for (; *s; s++)
+        if (*s == '"' || *s == '\\')
+            printf("\\%c", *s);
+        else if ((unsigned char) *s < 32)
+            printf("\\u%04x", *s);
+        else
+            putchar(*s);
+    putchar('"');
+}
+
+static int bench(const char* dir, options o, int json) {               // Solve every regular file in dir, sorted by name
+    DIR* d = opendir(dir);
+    if (!d) {
+        fprintf(stderr, "c error: cannot open directory %s\n", dir);
+        return 1;
+    }
+    int i, n = 0, cap = 64, solved = 0;
+    char** files = (char **) malloc(sizeof(char *) * cap);
+    struct dirent* entry;
+    while (files && (entry = readdir(d))) {
+        char* path = (char *) malloc(strlen(dir) + strlen(entry->d_name) + 2);
+        struct stat st;
+        if (!path)
+            break;
+        sprintf(path, "%s/%s", dir, entry->d_name);
+        if (stat(path, &st) || !S_ISREG(st.st_mode)) {
+            free(path);
+            continue;
+        }
+        if (n == cap) {
+            char** grown = (char **) realloc(files, sizeof(char *) * (cap *= 2));
+            if (!grown) {
+                free(path);
+                break;
+            }
+            files = grown;
+        }
+        files[n++] = path;
+    }
+    closedir(d);
+    if (!files) {
+        fprintf(stderr, "c error: out of memory\n");
+        return 1;
+    }
+    qsort(files, n, sizeof(char *), compareNames);
+
+    if (o.seconds <= 0)
+        o.seconds = 60;                                                 // The timeout is also the PAR-2 penalty base
+    o.verbose = 0;
+    double penalties = 0, propagations = 0, searched = 0;
+    if (json)
+        printf("{\n  \"timeout\": %g,\n  \"instances\": [", o.seconds);
+    else
+        printf("file,result,seconds,conflicts,propagations,props_per_second\n");
+    for (i = 0; i < n && !stopped; i++) {
+        outcome out = {micro_solver::UNKNOWN, 0, 0, 0};
+        int result = solveFile(files[i], o, &out);
+        if (out.seconds > o.seconds)                                    // --time only limits solve: an answer after
+            result = micro_solver::UNKNOWN;                             // a slow parse or preprocess is a timeout too
+        const char* name = resultName(result);
+        double rate = out.seconds > 0 ? out.propagations / out.seconds : 0;
+        if (result == micro_solver::SAT || result == micro_solver::UNSAT) {
+            solved++;
+            penalties += out.seconds;
+        } else
+            penalties += 2 * o.seconds;                                 // PAR-2: unsolved counts twice the timeout
+        propagations += out.propagations;
+        searched += out.seconds;
+        if (json) {
+            printf("%s\n    {\"file\": ", i ? "," : "");
+            printJsonString(files[i]);
+            printf(", \"result\": \"%s\", \"seconds\": %.3f, \"conflicts\": %i, \"propagations\": %lld, "
+                   "\"props_per_second\": %.0f}", name, out.seconds, out.conflicts, out.propagations, rate);
+        } else
+            printf("%s,%s,%.3f,%i,%lld,%.0f\n", files[i], name, out.seconds, out.conflicts, out.propagations, rate);
+        fflush(stdout);
+    }
+    int total = i;
+    double par2 = total ? penalties / total : 0, rate = searched > 0 ? propagations / searched : 0;
+    if (json)
+        printf("\n  ],\n  \"solved\": %i,\n  \"total\": %i,\n  \"par2\": %.3f,\n  \"props_per_second\": %.0f\n}\n",
+               solved, total, par2, rate);
+    else
+        fprintf(stderr, "c solved %i of %i, PAR-2 %.3f seconds, %.2f M props/s\n", solved, total, par2, rate / 1e6);
+    for (i = 0; i < n; i++)
+        free(files[i]);
+    free(files);
+    return 0;
+}
+
+static int batch(const char* list, const options& o) {                 // Solve the files named in list, one per line
+    micro_input input;
+    if (!input.open(list)) {
+        fprintf(stderr, "c error: cannot read %s\n", list);
+        return 1;
+    }
+    int i, n = 0;
+    char* names = (char *) malloc(input.size + 1);                      // The lines, each ended by 0
+    microsat_query* queries = (microsat_query *) malloc(sizeof(microsat_query) * (input.size / 2 + 1));
+    if (!names || !queries) {
+        free(names);
+        free(queries);
+        fprintf(stderr, "c error: out of memory\n");
+        return 1;
+    }
+    memcpy(names, input.data, input.size);
+    names[input.size] = '\n';
+    char *p = names, *end = names + input.size;
+    while (p < end) {
+        char* line = p;
+        while (*p != '\n')
+            p++;
+        char* stop = p++;
+        while (stop > line && (stop[-1] == '\r' || stop[-1] == ' ' || stop[-1] == '\t'))
+            stop--;
+        *stop = 0;
+        if (*line) {
+            queries[n].file = line;
+            queries[n].data = 0;
+            queries[n].size = 0;
+            n++;
+        }
+    }
+
+    micro_batch B(o.threads);
+    for (i = 0; i < o.threads; i++) {
+        B.solvers[i].engine = o.engine;
+        B.solvers[i].heuristic = o.heuristic;
+        B.solvers[i].maxconflicts = o.conflicts;
+        B.solvers[i].maxSeconds = o.seconds;
+        B.solvers[i].maxMemory = (long long) (o.megabytes * 1e6);
+        B.solvers[i].vivifyEffort = o.vivify;
+    }
+    B.preprocess = o.preprocess;
+    batching = &B;
+    double start = wall_clock();
+    int solved = B.solve(queries, n);
+    double seconds = wall_clock() - start;
+    batching = 0;
+    printf("file,result\n");
+    for (i = 0; i < n; i++)
+        printf("%s,%s\n", queries[i].file, resultName(queries[i].result));
+    fprintf(stderr, "c solved %i of %i on %i threads in %.2f seconds, %.1f formulas/s\n", solved, n, o.threads,
+            seconds, seconds > 0 ? n / seconds : 0);
+    free(names);
+    free(queries);
+    return solved < 0;
+}
+
+int main(int argc, char** argv) {
+    const char* file = 0, *directory = 0, *list = 0;
+    options o;
+    int i, json = 0;
+    for (i = 1; i < argc; i++)                                          // Options come before the input file
+        if (!strcmp(argv[i], "--engine=blocker"))
+            o.engine = micro_solver::BLOCKER;
+        else if (!strcmp(argv[i], "--engine=linked"))
+            o.engine = micro_solver::LINKED;
+        else if (!strcmp(argv[i], "--heuristic=mtf"))
+            o.heuristic = micro_solver::MTF;
+        else if (!strcmp(argv[i], "--heuristic=vmtf"))
+            o.heuristic = micro_solver::VMTF;
+        else if (!strcmp(argv[i], "--heuristic=vsids"))
+            o.heuristic = micro_solver::VSIDS;
+        else if (!strncmp(argv[i], "--threads=", 10) && (o.threads = atoi(argv[i] + 10)) > 0)
+            continue;
+        else if (!strcmp(argv[i], "--no-share"))
+            o.share = 0;
+        else if (!strcmp(argv[i], "--preprocess"))
+            o.preprocess = 1;
+        else if (!strncmp(argv[i], "--conflicts=", 12) && (o.conflicts = atoi(argv[i] + 12)) > 0)
+            continue;
+        else if (!strncmp(argv[i], "--time=", 7) && (o.seconds = atof(argv[i] + 7)) > 0)
+            continue;
+        else if (!strncmp(argv[i], "--memory=", 9) && (o.megabytes = atof(argv[i] + 9)) > 0)
+            continue;
+        else if (!strncmp(argv[i], "--progress=", 11) && (o.progress = atof(argv[i] + 11)) > 0)
+            continue;
+        else if (!strncmp(argv[i], "--bench=", 8) && argv[i][8])
+            directory = argv[i] + 8;
+        else if (!strcmp(argv[i], "--json"))
+            json = 1;
+        else if (!strncmp(argv[i], "--batch=", 8) && argv[i][8])
+            list = argv[i] + 8;
+        else if (!strncmp(argv[i], "--vivify=", 9) && argv[i][9] && (o.vivify = atoi(argv[i] + 9)) >= 0)
+            continue;
+        else if (!strncmp(argv[i], "--cube=", 7) && (o.cube = atoi(argv[i] + 7)) > 0)
+            continue;
+        else if (!strncmp(argv[i], "--icnf=", 7) && argv[i][7])
+            o.icnf = argv[i] + 7;
+        else if (!strncmp(argv[i], "--queue=", 8) && argv[i][8])
+            o.queue = argv[i] + 8;
+        else if (!strncmp(argv[i], "--worker=", 9) && argv[i][9])
+            o.worker = argv[i] + 9;
+        else if (!strncmp(argv[i], "--proof=", 8) && argv[i][8])
+            o.proof = argv[i] + 8;
+        else if (!strcmp(argv[i], "--binary-proof"))
+            o.binaryProof = 1;
+        else if (!file && (argv[i][0] != '-' || !argv[i][1]))
+            file = argv[i];
+        else
+            break;
+    if (!file + !directory + !list != 2 || i < argc || (o.proof && (directory || list || o.threads > 1 || o.cube ||
+        o.worker)) || ((o.icnf || o.queue) && (!o.cube || directory)) || (o.icnf && o.queue) ||
+        (o.worker && (o.cube || directory)) || (list && (o.cube || o.worker))) {
+        printf(usage, argv[0], argv[0], argv[0]);
+        return 1;
+    }
+    signal(SIGINT, interrupt_handler);
+    if (directory)
+        return bench(directory, o, json);
+    if (list)
+        return batch(list, o);
+
+    outcome out;
+    int result = solveFile(file, o, &out);
+    return result == micro_solver::SAT ? 10 : result == micro_solver::UNSAT ? 20 : result == micro_solver::PARSE_ERROR;
+}
+#endif
@@ -0,0 +1,80 @@
+/*********************************************************************[microsat.h]***
+
+  The MIT License
+
+  Copyright (c) 2014-2018 Marijn Heule
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+*************************************************************************************/
+
+/* The library interface of microsat, for C and C++ programs linked against microsat.c compiled as a library
+   (see README.md). C++ programs may also include microsat.c and use micro_solver directly. */
+
+#ifndef MICROSAT_H
+#define MICROSAT_H
+
+#include <stddef.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum {                                                              /* Results, the same as in micro_solver */
+    MICROSAT_UNKNOWN = -3, MICROSAT_PARSE_ERROR = -2, MICROSAT_MEMOUT = -1, MICROSAT_UNSAT = 0, MICROSAT_SAT = 1
+};
+
+typedef struct micro_solver micro_solver;
+
+micro_solver* microsat_create(void);                                /* An empty solver, 0 if out of memory */
+void microsat_reset(micro_solver* S);                               /* Forget the formula but keep the memory */
+void microsat_destroy(micro_solver* S);                             /* Free the solver and all of its memory */
+
+int microsat_parse(micro_solver* S, const char* data, size_t size); /* Replace the formula by DIMACS text, returns */
+int microsat_parse_file(micro_solver* S, const char* filename);     /* SAT, UNSAT (trivially), PARSE_ERROR or MEMOUT */
+const char* microsat_error(const micro_solver* S, int* line);       /* Why the last parse failed, and on which line */
+
+int microsat_add(micro_solver* S, int lit);                         /* Add lit to a new clause, 0 ends the clause */
+int microsat_solve(micro_solver* S, const int* assumptions, int n); /* SAT, UNSAT, UNKNOWN or MEMOUT */
+int microsat_val(micro_solver* S, int lit);                         /* lit or -lit, by the model after SAT */
+int microsat_failed(micro_solver* S, int lit);                      /* Is assumption lit in the core after UNSAT? */
+void microsat_limit(micro_solver* S, int conflicts, double seconds); /* Budgets of each call to solve (0 = none) */
+void microsat_interrupt(micro_solver* S);                           /* Make the running solve return UNKNOWN (from */
+                                                                    /* any thread); the next call to solve clears it */
+
+typedef struct microsat_query {                                     /* One formula of a batch: */
+    const char* file;                                               /* a DIMACS file (gzip, xz), or if 0 */
+    const char* data;                                               /* DIMACS text of size bytes */
+    size_t size;
+    int result;                                                     /* Set by microsat_batch */
+} microsat_query;
+
+/* Called by the thread that solved the query, while its solver still holds the formula (and the model) */
+typedef void (*microsat_answer)(microsat_query* query, micro_solver* S, void* arg);
+
+/* Solve the n queries on a pool of threads, each of which reuses one solver for all the queries it takes.
+   The budgets apply to each query. Returns the number of queries with a SAT or UNSAT result. */
+int microsat_batch(microsat_query* queries, int n, int threads, int conflicts, double seconds,
+                   microsat_answer answer, void* arg);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
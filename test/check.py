@@ -0,0 +1,155 @@
+#!/usr/bin/env python3
+# Solve generated formulas with microsat under various options and check the answers: models against the clauses,
+# UNSAT answers by checking the DRAT proof (text and binary) with a small forward RUP checker, and batch results
+# against single runs.
+#
+#   make test          or          test/check.py [MICROSAT]
+
+import os, random, subprocess, sys, tempfile
+
+SOLVER = sys.argv[1] if len(sys.argv) > 1 else './microsat'
+OPTIONS = [[], ['--engine=linked'], ['--heuristic=vmtf'], ['--heuristic=vsids'], ['--vivify=0'], ['--preprocess'],
+           ['--threads=4'], ['--threads=3', '--no-share'], ['--cube=3', '--threads=2'], ['--conflicts=1000000']]
+PROOFS = [[], ['--binary-proof'], ['--preprocess'], ['--engine=linked'], ['--heuristic=vsids']]
+
+
+def random_cnf(rng, n, ratio):
+    return n, [[rng.choice((-1, 1)) * rng.randint(1, n) for _ in range(3)] for _ in range(int(n * ratio))]
+
+
+def pigeonhole(holes):                                              # holes + 1 pigeons do not fit: unsatisfiable
+    var = lambda p, h: p * holes + h + 1
+    clauses = [[var(p, h) for h in range(holes)] for p in range(holes + 1)]
+    clauses += [[-var(p, h), -var(q, h)] for h in range(holes) for p in range(holes + 1) for q in range(p)]
+    return (holes + 1) * holes, clauses
+
+
+def write_cnf(path, n, clauses):
+    with open(path, 'w') as f:
+        f.write('p cnf %d %d\n' % (n, len(clauses)))
+        f.writelines(' '.join(map(str, c)) + ' 0\n' for c in clauses)
+
+
+def run(args):
+    p = subprocess.run([SOLVER] + args, stdout=subprocess.PIPE, stderr=subprocess.DEVNULL, universal_newlines=True)
+    return p.returncode, p.stdout
+
+
+def check_model(clauses, output):
+    model = set()
+    for line in output.splitlines():
+        if line.startswith('v'):
+            model.update(int(x) for x in line[1:].split())
+    return all(any(l in model for l in c) for c in clauses)
+
+
+def read_proof(path, binary):                                       # [(deleted, clause)], text or binary DRAT
+    data = open(path, 'rb').read()
+    steps = []
+    if binary:
+        i = 0
+        while i < len(data):
+            deleted, clause, i = data[i] == ord('d'), [], i + 1
+            while True:
+                value = shift = 0
+                while True:
+                    value |= (data[i] & 127) << shift
+                    shift += 7
+                    i += 1
+                    if data[i - 1] < 128:
+                        break
+                if not value:
+                    break
+                clause.append(-(value >> 1) if value & 1 else value >> 1)
+            steps.append((deleted, clause))
+        return steps
+    for line in data.decode().splitlines():
+        t = line.split()
+        if t and t[0] != 'c':
+            steps.append((t[0] == 'd', [int(x) for x in t[t[0] == 'd':-1]]))
+    return steps
+
+
+def propagate(db, assigned):                                        # Unit propagation, False on a conflict
+    changed = True
+    while changed:
+        changed = False
+        for c in db:
+            if any(l in assigned for l in c):
+                continue
+            free = [l for l in c if -l not in assigned]
+            if not free:
+                return False
+            if len(free) == 1:
+                assigned.add(free[0])
+                changed = True
+    return True
+
+
+def check_proof(clauses, steps):                                    # Every lemma is RUP, and the empty clause is derived
+    db = [tuple(set(c)) for c in clauses]                           # (without duplicate literals)
+    for deleted, c in steps:
+        if deleted:                                                 # Like drat-trim, ignore deletions of clauses
+            top = set()                                             # that are satisfied by the top-level units
+            propagate(db, top)
+            key = sorted(set(c))
+            for i, d in enumerate(db):
+                if sorted(d) == key and not any(l in top for l in c):
+                    del db[i]
+                    break
+            continue
+        if propagate(db, set(-l for l in c)):
+            return 'lemma %s is not RUP' % c
+        db.append(tuple(set(c)))
+        if not c:
+            return None
+    return 'no empty clause'
+
+
+def main():
+    rng = random.Random(1)
+    tmp = tempfile.mkdtemp()
+    failures = checked = 0
+    formulas = [random_cnf(rng, rng.randint(20, 60), rng.uniform(3.8, 4.6)) for _ in range(30)]
+    formulas += [pigeonhole(h) for h in (3, 4, 5)]
+    files = []
+    for k, (n, clauses) in enumerate(formulas):
+        path = os.path.join(tmp, 'f%02d.cnf' % k)
+        write_cnf(path, n, clauses)
+        files.append(path)
+        results = set()
+        for options in OPTIONS:
+            code, out = run(options + [path])
+            results.add(code)
+            checked += 1
+            if code not in (10, 20) or (code == 10 and not check_model(clauses, out)):
+                print('FAIL %s %s: exit %d or wrong model' % (' '.join(options), path, code))
+                failures += 1
+        if len(results) > 1:
+            print('FAIL %s: the options disagree' % path)
+            failures += 1
+        if 20 in results:
+            for options in PROOFS:
+                proof = os.path.join(tmp, 'proof')
+                code, out = run(options + ['--proof=' + proof, path])
+                error = check_proof(clauses, read_proof(proof, '--binary-proof' in options)) if code == 20 else 'exit %d' % code
+                checked += 1
+                if error:
+                    print('FAIL %s %s: %s' % (' '.join(options), path, error))
+                    failures += 1
+
+    with open(os.path.join(tmp, 'list'), 'w') as f:                 # The batch driver agrees with single runs
+        f.writelines(p + '\n' for p in files)
+    code, out = run(['--threads=4', '--batch=' + os.path.join(tmp, 'list')])
+    names = {10: 'SAT', 20: 'UNSAT'}
+    for line, path in zip(out.splitlines()[1:], files):
+        checked += 1
+        if line != '%s,%s' % (path, names.get(run([path])[0])):
+            print('FAIL --batch: %s' % line)
+            failures += 1
+    print('c check: %d of %d runs passed' % (checked - failures, checked))
+    return failures != 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
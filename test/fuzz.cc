@@ -0,0 +1,210 @@
+// Random incremental fuzzer: adds clauses between calls to solve, with assumptions, budgets, preprocessing and
+// solver reuse, and checks every answer against brute force on at most 12 variables. A few fixed regression cases
+// run first.
+//
+//   make test          or          g++ -O2 -pthread test/fuzz.cc -o fuzz && ./fuzz [RUNS] [FIRST_SEED]
+
+#include "../microsat.c"
+#include <vector>
+
+typedef std::vector<int> clause;
+
+static unsigned long long state;
+
+static int rnd(int n) {                                             // Uniform in 0..n-1
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return (int) ((state >> 33) % n);
+}
+
+static int satisfiable(const std::vector<clause>& F, int n, const clause& units) { // By trying all assignments
+    for (int bits = 0; bits < (1 << n); bits++) {
+        int ok = 1;
+        for (size_t u = 0; ok && u < units.size(); u++)
+            ok = ((bits >> (abs(units[u]) - 1)) & 1) == (units[u] > 0);
+        for (size_t c = 0; ok && c < F.size(); c++) {
+            ok = 0;
+            for (size_t i = 0; !ok && i < F[c].size(); i++)
+                ok = ((bits >> (abs(F[c][i]) - 1)) & 1) == (F[c][i] > 0);
+        }
+        if (ok)
+            return 1;
+    }
+    return 0;
+}
+
+static const char* check(micro_solver* S, unsigned seed) {          // One random session, 0 if every answer is right
+    state = seed;
+    S->engine = rnd(2) ? micro_solver::BLOCKER : micro_solver::LINKED;
+    S->heuristic = rnd(3);
+    S->maxLemmas = 1 + rnd(20);                                     // reduceDB runs often
+    S->lemmaStep = 1 + rnd(10);
+    S->vivifyEffort = rnd(2) ? 100 : 0;
+    S->vivifyInterval = 1 + rnd(20);
+    if (S->initCDCL(0, 0) != micro_solver::SAT)
+        return "initCDCL failed";
+    std::vector<clause> F;
+    int n = 3 + rnd(6), rounds = 1 + rnd(8), preprocessed = 0;
+    for (int r = 0; r < rounds; r++) {
+        n += (n < 12) ? rnd(3) : 0;                                 // Later clauses may use new variables
+        if (n > 12)
+            n = 12;
+        int added = 1 + rnd(n + 2);                                 // About 4n clauses after a few rounds
+        for (int c = 0; c < added; c++) {
+            clause C;
+            int size = rnd(4) ? 3 : 1 + rnd(6);
+            for (int i = 0; i < size; i++)
+                C.push_back((rnd(2) ? 1 : -1) * (1 + rnd(n)));
+            for (int i = 0; i < size; i++)
+                S->add(C[i]);
+            S->add(0);
+            F.push_back(C);
+        }
+        if (!preprocessed && r > 0 && !rnd(3)) {                    // Eliminate some variables between two calls
+            for (int v = 1; v <= n; v++)
+                if (rnd(2))
+                    S->freeze(v);
+            preprocessed = 1;
+            int result = S->preprocess();
+            if (result == micro_solver::UNSAT && satisfiable(F, n, clause()))
+                return "preprocess claims UNSAT";
+        }
+        clause assume;
+        for (int a = rnd(4); a > 0; a--)
+            assume.push_back((rnd(2) ? 1 : -1) * (1 + rnd(n)));
+        S->maxconflicts = rnd(2) ? 1 + rnd(5) : INT_MAX;            // Small budgets: the search is resumed
+        int result, calls = 0;
+        while ((result = S->solve(assume.data(), (int) assume.size())) == micro_solver::UNKNOWN)
+            if (++calls > 100000)
+                return "no answer";
+        int expected = satisfiable(F, n, assume);
+        if (result != (expected ? micro_solver::SAT : micro_solver::UNSAT))
+            return "wrong answer";
+        if (result == micro_solver::SAT) {
+            for (size_t c = 0; c < F.size(); c++) {
+                int ok = 0;
+                for (size_t i = 0; i < F[c].size(); i++)
+                    ok |= (S->val(F[c][i]) == F[c][i]);
+                if (!ok)
+                    return "model falsifies a clause";
+            }
+            for (size_t a = 0; a < assume.size(); a++)
+                if (S->val(assume[a]) != assume[a])
+                    return "model falsifies an assumption";
+        }
+        else {
+            clause core;                                            // The failed assumptions suffice for UNSAT
+            for (size_t a = 0; a < assume.size(); a++)
+                if (S->failed(assume[a]))
+                    core.push_back(assume[a]);
+            if (satisfiable(F, n, core))
+                return "core is satisfiable";
+            if (S->inconsistent && satisfiable(F, n, clause()))
+                return "inconsistent without assumptions";
+        }
+    }
+    return 0;
+}
+
+static void pigeonhole(micro_solver* S, int holes) {                // holes + 1 pigeons do not fit: unsatisfiable
+    for (int p = 0; p <= holes; p++) {
+        for (int h = 0; h < holes; h++)
+            S->add(1 + p * holes + h);
+        S->add(0);
+    }
+    for (int h = 0; h < holes; h++)
+        for (int p = 0; p <= holes; p++)
+            for (int q = 0; q < p; q++) {
+                S->add(-(1 + p * holes + h));
+                S->add(-(1 + q * holes + h));
+                S->add(0);
+            }
+}
+
+static const char* memoryBudget() {                                 // A tight budget on the DB ends the search soon
+    micro_solver S;
+    if (S.initCDCL(0, 0) != micro_solver::SAT)
+        return "initCDCL failed";
+    pigeonhole(&S, 9);
+    S.maxconflicts = 1;                                             // Load the clauses
+    if (S.solve(0, 0) != micro_solver::UNKNOWN)
+        return "pigeonhole solved in one conflict";
+    S.maxMemory = (long long) sizeof(int) * (S.mem_fixed + 2000);   // Room for a few hundred lemmas
+    S.maxconflicts = 100000;
+    if (S.solve(0, 0) != micro_solver::UNKNOWN || S.nConflicts - S.startConflicts >= 10000)
+        return "memory budget ignored";
+    return 0;
+}
+
+static const char* staleInterrupt() {                               // An interrupt between two calls is dropped
+    micro_solver S;
+    if (S.initCDCL(0, 0) != micro_solver::SAT)
+        return "initCDCL failed";
+    pigeonhole(&S, 9);
+    S.maxconflicts = 1000;                                          // Not solved in 1000 conflicts
+    S.interrupt();
+    if (S.solve(0, 0) != micro_solver::UNKNOWN || S.nConflicts - S.startConflicts < 1000)
+        return "interrupt after solve stopped the next call";
+    return 0;
+}
+
+static const char* switchHeuristic() {                              // VSIDS after many conflicts under MTF and VMTF
+    micro_solver S;
+    if (S.initCDCL(0, 0) != micro_solver::SAT)
+        return "initCDCL failed";
+    pigeonhole(&S, 9);
+    S.maxconflicts = 10000;                                         // 1/0.95^20000 overflows a double
+    for (int h = micro_solver::MTF; h <= micro_solver::VSIDS; h++) {
+        S.heuristic = h;
+        if (S.solve(0, 0) != micro_solver::UNKNOWN)
+            return "pigeonhole solved";
+    }
+    for (int v = 1; v <= S.nVars; v++)
+        if (!(S.score[v] < 1e300))
+            return "scores overflow after switching to VSIDS";
+    return 0;
+}
+
+static void __attribute__((noinline)) dirtyStack() {              // Leave garbage where the next solver will be
+    volatile unsigned char junk[2 * sizeof(micro_solver)];
+    for (size_t i = 0; i < sizeof(junk); i++)
+        junk[i] = 0x5a;
+}
+
+static const char* __attribute__((noinline)) newSolver() {          // A new solver does not use stale memory
+    micro_solver S;
+    int line = -1;
+    if (microsat_error(&S, &line) || line || microsat_failed(&S, 1) || S.nCore || S.inconsistent || S.resumable)
+        return "a new solver has stale results";
+    if (microsat_solve(&S, 0, 0) != MICROSAT_SAT || S.nConflicts)
+        return "a new solver cannot solve the empty formula";
+    return 0;
+}
+
+static const char* freshSolver() {                                  // (in the frame of dirtyStack)
+    dirtyStack();
+    return newSolver();
+}
+
+int main(int argc, char** argv) {
+    int runs = argc > 1 ? atoi(argv[1]) : 2000;
+    unsigned first = argc > 2 ? (unsigned) atoi(argv[2]) : 1;
+    const char* (*regressions[])() = {freshSolver, memoryBudget, staleInterrupt, switchHeuristic};
+    for (size_t r = 0; r < sizeof(regressions) / sizeof(regressions[0]); r++) {
+        const char* error = regressions[r]();
+        if (error) {
+            printf("c fuzz: %s\n", error);
+            return 1;
+        }
+    }
+    micro_solver reused;                                            // Every other session reuses its storage
+    for (int i = 0; i < runs; i++) {
+        micro_solver fresh;
+        const char* error = check((i & 1) ? &reused : &fresh, first + i);
+        if (error) {
+            printf("c fuzz: seed %u: %s\n", first + i, error);
+            return 1;
+        }
+    }
+    printf("c fuzz: %i sessions passed\n", runs);
+    return 0;
+}